@@ -24,6 +24,29 @@ https://github.com/mvac7/SDCC_MSX_fR3eL
 #define  POP_AF           __asm pop  AF __endasm
 
 
+// Some MSX system hooks
+#define  HOOK_KEYI        0xFD9A  //H.KEYI Interrupt handler device other than the VDP
+#define  HOOK_TIMI        0xFD9F  //H.TIMI Interrupt handler VDP VBLANK
+#define  HOOK_CHPU        0xFDA4  //H.CHPU Character output (CHPUT)
+#define  HOOK_KEYC        0xFDCC  //H.KEYC Keyboard decoder
+#define  HOOK_STKE        0xFEDA  //H.STKE Stack error / start of BASIC (ROMs with CALL)
+
+#define  HOOK_SIZE        5       //bytes of each hook
+#define  HOOK_CHAIN_SIZE  10      //bytes of the trampoline of a chained hook
+
+
+// Maximum number of hooks in the registry (change it when compiling the
+// interruptM1_HookRegistry object)
+#ifndef HOOKS_MAX
+#define HOOKS_MAX	8
+#endif
+
+typedef struct {
+	unsigned int hook;	// hook address
+	char* slot;			// buffer with the saved hook
+} HOOK_RECORD;
+
+
 
 
 /* =============================================================================
@@ -48,6 +71,26 @@ void Install_TIMI(void (*func)(void));
 
 
 
+/* =============================================================================
+ Install_TIMI_Chained
+
+ Function : Set a new TIMI hook function, keeping the old one. 
+            The new function is executed first and then the current hook
+            (also the inter-slot calls with RST 30h or other chained hook).
+            Call Save_TIMI before to restore the hook with Restore_TIMI.
+            The hook jumps to a trampoline generated in the buffer [chain]
+            (HOOK_CHAIN_SIZE bytes). The buffer and the function must be in
+            page 3 (0xC000-0xFFFF), since the interrupt can arrive with any
+            slot in pages 0 to 2 (BIOS and disk inter-slot calls).
+            Object: interruptM1_HookChain.rel
+ Input    : [func] Function address
+            [chain] address of a HOOK_CHAIN_SIZE bytes buffer in page 3
+ Output   : -
+============================================================================= */
+void Install_TIMI_Chained(void (*func)(void), char* chain);
+
+
+
 /* =============================================================================
  Restore_TIMI
 
@@ -62,7 +105,9 @@ void Restore_TIMI(void);
 /* =============================================================================
  Disable_TIMI
 
- Function : Disable the TIMI hook (Add a ret on the hook).
+ Function : Disable the TIMI hook (Add a ret on the hook and clear the
+            address, so that Resume_TIMI does not enable it).
+            The 3 first bytes of the hook are C9 C9 C9.
  Input    : -
  Output   : -
 ============================================================================= */
@@ -70,6 +115,31 @@ void Disable_TIMI(void);
 
 
 
+/* =============================================================================
+ Pause_TIMI
+
+ Function : Pause the TIMI hook (change the JP opcode to a RET).
+            Other hooks (RET, RST 30h) are not changed.
+            It can be called with the interrupts enabled.
+ Input    : -
+ Output   : -
+============================================================================= */
+void Pause_TIMI(void);
+
+
+
+/* =============================================================================
+ Resume_TIMI
+
+ Function : Resume the TIMI hook paused with Pause_TIMI. Only a RET
+            followed by the address of a function is changed to a JP.
+ Input    : -
+ Output   : -
+============================================================================= */
+void Resume_TIMI(void);
+
+
+
 /* =============================================================================
  Save_KEYI
 
@@ -92,6 +162,26 @@ void Install_KEYI(void (*func)(void));
 
 
 
+/* =============================================================================
+ Install_KEYI_Chained
+
+ Function : Set a new KEYI hook function, keeping the old one. 
+            The new function is executed first and then the current hook
+            (also the inter-slot calls with RST 30h or other chained hook).
+            Call Save_KEYI before to restore the hook with Restore_KEYI.
+            The hook jumps to a trampoline generated in the buffer [chain]
+            (HOOK_CHAIN_SIZE bytes). The buffer and the function must be in
+            page 3 (0xC000-0xFFFF), since the interrupt can arrive with any
+            slot in pages 0 to 2 (BIOS and disk inter-slot calls).
+            Object: interruptM1_HookChain.rel
+ Input    : [func] Function address
+            [chain] address of a HOOK_CHAIN_SIZE bytes buffer in page 3
+ Output   : -
+============================================================================= */
+void Install_KEYI_Chained(void (*func)(void), char* chain);
+
+
+
 /* =============================================================================
  Restore_KEYI
 
@@ -106,7 +196,9 @@ void Restore_KEYI(void);
 /* =============================================================================
  Disable_KEYI
 
- Function : Disable the KEYI hook (Add a ret on the hook).
+ Function : Disable the KEYI hook (Add a ret on the hook and clear the
+            address, so that Resume_KEYI does not enable it).
+            The 3 first bytes of the hook are C9 C9 C9.
  Input    : -
  Output   : -
 ============================================================================= */
@@ -114,5 +206,144 @@ void Disable_KEYI(void);
 
 
 
+/* =============================================================================
+ Pause_KEYI
+
+ Function : Pause the KEYI hook (change the JP opcode to a RET).
+            Other hooks (RET, RST 30h) are not changed.
+            It can be called with the interrupts enabled.
+ Input    : -
+ Output   : -
+============================================================================= */
+void Pause_KEYI(void);
+
+
+
+/* =============================================================================
+ Resume_KEYI
+
+ Function : Resume the KEYI hook paused with Pause_KEYI. Only a RET
+            followed by the address of a function is changed to a JP.
+ Input    : -
+ Output   : -
+============================================================================= */
+void Resume_KEYI(void);
+
+
+
+/* =============================================================================
+ Save_Hook
+
+ Function : Save a hook (5 bytes)
+ Input    : [hook] hook address
+            [slot] address of a 5 bytes buffer
+ Output   : -
+============================================================================= */
+void Save_Hook(unsigned int hook, char* slot);
+
+
+
+/* =============================================================================
+ Install_Hook
+
+ Function : Set a JP to a function in a hook
+ Input    : [hook] hook address
+            [func] Function address
+ Output   : -
+============================================================================= */
+void Install_Hook(unsigned int hook, void (*func)(void));
+
+
+
+/* =============================================================================
+ Restore_Hook
+
+ Function : Restore a hook saved with Save_Hook
+ Input    : [hook] hook address
+            [slot] address of the 5 bytes buffer
+ Output   : -
+============================================================================= */
+void Restore_Hook(unsigned int hook, char* slot);
+
+
+
+/* =============================================================================
+ Disable_Hook
+
+ Function : Disable a hook (Add a ret on the hook and clear the address,
+            so that Resume_Hook does not enable it).
+            The 3 first bytes of the hook are C9 C9 C9.
+ Input    : [hook] hook address
+ Output   : -
+============================================================================= */
+void Disable_Hook(unsigned int hook);
+
+
+
+/* =============================================================================
+ Pause_Hook
+
+ Function : Pause a hook with a JP (change the JP opcode to a RET).
+            Other hooks (RET, RST 30h) are not changed.
+            The address of the function is kept.
+            It can be called with the interrupts enabled.
+ Input    : [hook] hook address
+ Output   : -
+============================================================================= */
+void Pause_Hook(unsigned int hook);
+
+
+
+/* =============================================================================
+ Resume_Hook
+
+ Function : Resume a hook paused with Pause_Hook (change the RET to JP).
+            Only a RET followed by the address of a function is changed:
+            a hook not installed (RET, 0xC9C9) is not changed.
+ Input    : [hook] hook address
+ Output   : -
+============================================================================= */
+void Resume_Hook(unsigned int hook);
+
+
+
+/* =============================================================================
+ Init_HookRegistry
+
+ Function : Empty the registry of saved hooks
+            Object: interruptM1_HookRegistry.rel
+ Input    : -
+ Output   : -
+============================================================================= */
+void Init_HookRegistry(void);
+
+
+
+/* =============================================================================
+ Register_Hook
+
+ Function : Save a hook and add it to the registry, 
+            to restore it with Restore_AllHooks.
+            Object: interruptM1_HookRegistry.rel
+ Input    : [hook] hook address
+            [slot] address of a 5 bytes buffer
+ Output   : 1 = saved; 0 = the registry is full
+============================================================================= */
+char Register_Hook(unsigned int hook, char* slot);
+
+
+
+/* =============================================================================
+ Restore_AllHooks
+
+ Function : Restore all the hooks of the registry, in reverse order (LIFO)
+            Object: interruptM1_HookRegistry.rel
+ Input    : -
+ Output   : -
+============================================================================= */
+void Restore_AllHooks(void);
+
+
+
 
 #endif
@@ -0,0 +1,112 @@
+/* =============================================================================
+Z80 interrupt M1 TIMI Subscribers MSX SDCC Library (fR3eL Project)
+List of VBLANK functions behind the TIMI hook, with constant-time subscribe and
+unsubscribe.
+https://github.com/mvac7/SDCC_MSX_fR3eL
+============================================================================= */
+
+#ifndef  __INTERRUPT_M1_SUBSCRIBERS_H__
+#define  __INTERRUPT_M1_SUBSCRIBERS_H__
+
+
+#define  TIMI_SUBS_SIZE  10    //bytes of the list: push AF + JP, pop AF + old hook
+
+
+// Node of the list. It is provided by each module, in page 3 (0xC000 or
+// higher): it is executed from the TIMI hook, with any slot in pages 0 to 2.
+// It must not be modified while it is subscribed.
+// It contains the code executed in the interrupt: CALL func + JP next
+typedef struct {
+	char code[6];		// CALL func / JP next node
+	unsigned int link;	// address of the JP operand that points to this node
+} TIMI_SUBSCRIBER;
+
+
+
+
+/* =============================================================================
+ Init_Subscribers
+
+ Function : Initialize the list of subscribers (empty).
+            The list is executed from the TIMI hook: it must be in page 3.
+ Input    : [list] address of a TIMI_SUBS_SIZE bytes buffer in page 3
+ Output   : -
+============================================================================= */
+void Init_Subscribers(char* list);
+
+
+
+/* =============================================================================
+ Install_Subscribers
+
+ Function : Save the TIMI hook and set the list of subscribers on it.
+            The old hook is executed after the subscribers.
+ Input    : -
+ Output   : -
+============================================================================= */
+void Install_Subscribers(void);
+
+
+
+/* =============================================================================
+ Restore_Subscribers
+
+ Function : Restore the TIMI hook saved by Install_Subscribers
+ Input    : -
+ Output   : -
+============================================================================= */
+void Restore_Subscribers(void);
+
+
+
+/* =============================================================================
+ Subscribe_TIMI
+
+ Function : Add a function to the list of subscribers (it is executed first).
+            It can be called with the interrupts enabled.
+ Input    : [TIMI_SUBSCRIBER*] node of the subscriber
+            [func] Function address
+ Output   : -
+============================================================================= */
+void Subscribe_TIMI(TIMI_SUBSCRIBER* node, void (*func)(void));
+
+
+
+/* =============================================================================
+ Unsubscribe_TIMI
+
+ Function : Remove a subscriber from the list.
+            It can be called with the interrupts enabled or from a subscriber.
+ Input    : [TIMI_SUBSCRIBER*] node of a subscribed function
+ Output   : -
+============================================================================= */
+void Unsubscribe_TIMI(TIMI_SUBSCRIBER* node);
+
+
+
+/* =============================================================================
+ Pause_Subscriber
+
+ Function : Pause a subscriber without removing it from the list (the CALL is
+            changed to a LD HL,nn that skips the address of the function).
+            It can be called with the interrupts enabled or from a subscriber.
+ Input    : [TIMI_SUBSCRIBER*] node of a subscribed function
+ Output   : -
+============================================================================= */
+void Pause_Subscriber(TIMI_SUBSCRIBER* node);
+
+
+
+/* =============================================================================
+ Resume_Subscriber
+
+ Function : Resume a subscriber paused with Pause_Subscriber
+ Input    : [TIMI_SUBSCRIBER*] node of a subscribed function
+ Output   : -
+============================================================================= */
+void Resume_Subscriber(TIMI_SUBSCRIBER* node);
+
+
+
+
+#endif
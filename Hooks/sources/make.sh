@@ -0,0 +1,17 @@
+#!/bin/sh
+# Build of the objects on Linux/macOS (same as MAKEFILE.BAT)
+set -e
+cd "$(dirname "$0")"
+# get SDCC version
+sdcc -v
+mkdir -p build
+echo Compiling Object
+sdcc -mz80 -c -o build/ src/interruptM1_Hooks.c
+echo Compiling Object for Install_ISR_Auto
+sdcc -mz80 -c -DHOOKS_ISR_AUTO -o build/interruptM1_HooksAuto.rel src/interruptM1_Hooks.c
+echo Compiling Object of the registry of hooks
+sdcc -mz80 -c -o build/ src/interruptM1_HookRegistry.c
+echo Compiling Object of the chained hooks
+sdcc -mz80 -c -o build/ src/interruptM1_HookChain.c
+echo Compiling Object of the TIMI subscribers
+sdcc -mz80 -c -o build/ src/interruptM1_Subscribers.c
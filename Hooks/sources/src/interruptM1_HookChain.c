@@ -0,0 +1,161 @@
+/* =============================================================================
+Z80 interrupt M1 Hooks MSX SDCC Library (fR3eL Project)
+Chained hooks
+Version: 1.2 (17/10/2026)
+Author: mvac7/303bcn
+Architecture: MSX
+Format: C Object (SDCC .rel)
+Programming language: C and Z80 assembler
+
+fR3eL Project
+https://github.com/mvac7/SDCC_MSX_fR3eL
+
+Description:
+Install a function in the TIMI or KEYI hook keeping the function that was
+installed before. The hook jumps to a trampoline, in a buffer of page 3 given
+by the program, that calls the new function and then executes the 5 bytes
+that the hook had. A chained hook installed after another one keeps both.
+
+The JP of the hook is written with Install_Hook, so with the
+interruptM1_HooksAuto object the ISR of Install_ISR_Auto is also updated.
+
+History of versions:
+- v1.2 (17/10/2026) Chains the current hook, not the one saved by Save_TIMI/Save_KEYI
+- v1.1 (17/10/2026) The program gives the buffer of the trampoline
+- v1.0 (17/10/2026) First version (before in interruptM1_Hooks v1.3)
+============================================================================= */
+
+#include "../include/interruptM1_Hooks.h"
+
+
+#define HKEYI	 0xFD9A //Hook KEYI. Interrupt handler device other than the VDP. (RS-232C, MSX-Midi, etc) 
+#define HTIMI	 0xFD9F //Hook TIMI. Interrupt handler VDP VBLANK
+
+
+void Build_HookChain(void);
+
+
+
+
+/* =============================================================================
+ Install_TIMI_Chained
+
+ Function : Set a new TIMI hook function, keeping the old one. 
+            The new function is executed first and then the current hook
+            (also the inter-slot calls with RST 30h or other chained hook).
+            Call Save_TIMI before to restore the hook with Restore_TIMI.
+            The hook jumps to a trampoline generated in the buffer [chain]
+            (HOOK_CHAIN_SIZE bytes). The buffer and the function must be in
+            page 3 (0xC000-0xFFFF), since the interrupt can arrive with any
+            slot in pages 0 to 2 (BIOS and disk inter-slot calls).
+ Input    : [func] Function address
+            [chain] address of a HOOK_CHAIN_SIZE bytes buffer in page 3
+ Output   : -
+============================================================================= */
+void Install_TIMI_Chained(void (*func)(void), char* chain) __naked
+{
+func;	//HL
+chain;	//DE
+__asm
+	ld   A,I           ;P/V = IFF2 (interrupts enabled)
+	jp   PE,1$
+	ld   A,I           ;NMOS Z80: read again if an interrupt was accepted
+1$:
+	di
+	push AF
+
+	push DE            ;trampoline
+	ex   DE,HL
+	ld   BC,#HTIMI
+	call _Build_HookChain
+
+	pop  DE
+	ld   HL,#HTIMI
+	call _Install_Hook ;add a JP to the trampoline
+
+	pop  AF
+	ret  PO            ;IF interrupts were disabled THEN exit
+	ei
+	ret
+__endasm;
+}
+
+
+
+/* =============================================================================
+ Install_KEYI_Chained
+
+ Function : Set a new KEYI hook function, keeping the old one. 
+            The new function is executed first and then the current hook
+            (also the inter-slot calls with RST 30h or other chained hook).
+            Call Save_KEYI before to restore the hook with Restore_KEYI.
+            The hook jumps to a trampoline generated in the buffer [chain]
+            (HOOK_CHAIN_SIZE bytes). The buffer and the function must be in
+            page 3 (0xC000-0xFFFF), since the interrupt can arrive with any
+            slot in pages 0 to 2 (BIOS and disk inter-slot calls).
+ Input    : [func] Function address
+            [chain] address of a HOOK_CHAIN_SIZE bytes buffer in page 3
+ Output   : -
+============================================================================= */
+void Install_KEYI_Chained(void (*func)(void), char* chain) __naked
+{
+func;	//HL
+chain;	//DE
+__asm
+	ld   A,I           ;P/V = IFF2 (interrupts enabled)
+	jp   PE,1$
+	ld   A,I           ;NMOS Z80: read again if an interrupt was accepted
+1$:
+	di
+	push AF
+
+	push DE            ;trampoline
+	ex   DE,HL
+	ld   BC,#HKEYI
+	call _Build_HookChain
+
+	pop  DE
+	ld   HL,#HKEYI
+	call _Install_Hook ;add a JP to the trampoline
+
+	pop  AF
+	ret  PO            ;IF interrupts were disabled THEN exit
+	ei
+	ret
+__endasm;
+}
+
+
+
+/* -----------------------------------------------------------------------------
+ Build_HookChain
+
+ Generates the trampoline of a chained hook:
+   push AF
+   call func
+   pop  AF
+   (5 bytes of the hook: JP, RST 30h or RET)
+ Input: [HL] trampoline; [DE] function; [BC] hook
+----------------------------------------------------------------------------- */
+void Build_HookChain(void) __naked
+{
+__asm
+	ld   (HL),#0xF5    ;push AF (A = VDP status for the old hook)
+	inc  HL
+	ld   (HL),#0xCD    ;call func
+	inc  HL
+	ld   (HL),E
+	inc  HL
+	ld   (HL),D
+	inc  HL
+	ld   (HL),#0xF1    ;pop AF
+	inc  HL
+
+	ex   DE,HL
+	ld   H,B
+	ld   L,C
+	ld   BC,#5
+	ldir               ;current hook
+	ret
+__endasm;
+}
\ No newline at end of file
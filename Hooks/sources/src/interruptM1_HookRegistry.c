@@ -0,0 +1,86 @@
+/* =============================================================================
+Z80 interrupt M1 Hooks MSX SDCC Library (fR3eL Project)
+Registry of saved hooks
+Version: 1.0 (17/10/2026)
+Author: mvac7/303bcn
+Architecture: MSX
+Format: C Object (SDCC .rel)
+Programming language: C
+
+fR3eL Project
+https://github.com/mvac7/SDCC_MSX_fR3eL
+
+Description:
+Saves the hooks used by the program and restores all of them before leaving,
+in reverse order (LIFO), so that a hook changed twice ends up with its
+original value. Uses Save_Hook and Restore_Hook of interruptM1_Hooks.
+
+History of versions:
+- v1.0 (17/10/2026) First version (before in interruptM1_Hooks v1.3)
+============================================================================= */
+
+#include "../include/interruptM1_Hooks.h"
+
+
+HOOK_RECORD HOOKS_registry[HOOKS_MAX];
+char HOOKS_count;
+
+
+
+
+/* =============================================================================
+ Init_HookRegistry
+
+ Function : Empty the registry of saved hooks
+ Input    : -
+ Output   : -
+============================================================================= */
+void Init_HookRegistry(void)
+{
+	HOOKS_count = 0;
+}
+
+
+
+/* =============================================================================
+ Register_Hook
+
+ Function : Save a hook and add it to the registry, 
+            to restore it with Restore_AllHooks.
+ Input    : [hook] hook address
+            [slot] address of a 5 bytes buffer
+ Output   : 1 = saved; 0 = the registry is full
+============================================================================= */
+char Register_Hook(unsigned int hook, char* slot)
+{
+	HOOK_RECORD* record;
+
+	if (HOOKS_count >= HOOKS_MAX) return 0;
+
+	Save_Hook(hook, slot);
+
+	record = &HOOKS_registry[HOOKS_count++];
+	record->hook = hook;
+	record->slot = slot;
+	return 1;
+}
+
+
+
+/* =============================================================================
+ Restore_AllHooks
+
+ Function : Restore all the hooks of the registry, in reverse order (LIFO)
+ Input    : -
+ Output   : -
+============================================================================= */
+void Restore_AllHooks(void)
+{
+	HOOK_RECORD* record;
+
+	while (HOOKS_count > 0)
+	{
+		record = &HOOKS_registry[--HOOKS_count];
+		Restore_Hook(record->hook, record->slot);
+	}
+}
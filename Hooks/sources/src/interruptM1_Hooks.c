@@ -1,6 +1,6 @@
 /* =============================================================================
 Z80 interrupt M1 Hooks MSX SDCC Library (fR3eL Project)
-Version: 1.2 (31/12/2024)
+Version: 1.5 (17/10/2026)
 Author: mvac7/303bcn
 Architecture: MSX
 Format: C Object (SDCC .rel)
@@ -14,6 +14,12 @@ Library with basic functions to control the MSX system hooks called from the
 Z80 Mode 1 interrupt ISR (Interrupt Service Routine).    
 
 History of versions:
+- v1.5 (17/10/2026) The registry and the chained hooks are separate objects
+                     (interruptM1_HookRegistry, interruptM1_HookChain)
+- v1.4 (17/10/2026) Pause and resume of the hooks (only the opcode is changed).
+                     The Disable functions write C9 C9 C9 (RET and the address),
+                     before only the first byte.
+- v1.3 (17/10/2026) Generic functions for any hook. Registry of saved hooks.
 - v1.2 (31/12/2024) Update to SDCC (4.1.12) Z80 calling conventions
 - v1.1 ( 4/07/2021) More functions to control the two Hooks (added KEYI)
 - v1.0 ( 4/07/2011) First version. Published in Avelino Herrera's WEB 
@@ -29,6 +35,15 @@ History of versions:
 #define HTIMI	 0xFD9F //Hook TIMI. Interrupt handler VDP VBLANK
 
 
+// Compiled with -DHOOKS_ISR_AUTO, every change of a hook updates the ISR
+// installed with Install_ISR_Auto (interruptM1_ISR library).
+#ifdef HOOKS_ISR_AUTO
+#define HOOK_CHANGED	jp _Update_ISR_Auto
+#else
+#define HOOK_CHANGED	ret
+#endif
+
+
 char OLD_TIMI[5];
 char OLD_HKEYI[5];
 
@@ -36,22 +51,30 @@ char OLD_HKEYI[5];
 
 
 /* =============================================================================
- Save_TIMI
+ Save_Hook
 
- Function : Save TIME hook vector
- Input    : -
+ Function : Save a hook (5 bytes)
+ Input    : [hook] hook address
+            [slot] address of a 5 bytes buffer
  Output   : -
 ============================================================================= */
-void Save_TIMI(void) __naked
+void Save_Hook(unsigned int hook, char* slot) __naked
 {
+hook;	//HL
+slot;	//DE
 __asm
+	ld   A,I           ;P/V = IFF2 (interrupts enabled)
+	jp   PE,1$
+	ld   A,I           ;NMOS Z80: read again if an interrupt was accepted
+1$:
 	di
-  
-	ld	 HL,#HTIMI
-	ld	 DE,#_OLD_TIMI
-	ld	 BC,#5
+	push AF
+
+	ld   BC,#HOOK_SIZE
 	ldir
-  
+
+	pop  AF
+	ret  PO           ;IF interrupts were disabled THEN exit
 	ei
 	ret
 __endasm;
@@ -59,6 +82,186 @@ __endasm;
 
 
 
+/* =============================================================================
+ Install_Hook
+
+ Function : Set a JP to a function in a hook
+ Input    : [hook] hook address
+            [func] Function address
+ Output   : -
+============================================================================= */
+void Install_Hook(unsigned int hook, void (*func)(void)) __naked
+{
+hook;	//HL
+func;	//DE
+__asm
+	ld   A,I           ;P/V = IFF2 (interrupts enabled)
+	jp   PE,1$
+	ld   A,I           ;NMOS Z80: read again if an interrupt was accepted
+1$:
+	di
+	push AF
+
+	ld   (HL),#0xC3    ;add a JP
+	inc  HL
+	ld   (HL),E
+	inc  HL
+	ld   (HL),D
+
+	pop  AF
+	jp   PO,2$         ;IF interrupts were disabled THEN do not enable
+	ei
+2$:
+	HOOK_CHANGED
+__endasm;
+}
+
+
+
+/* =============================================================================
+ Restore_Hook
+
+ Function : Restore a hook saved with Save_Hook
+ Input    : [hook] hook address
+            [slot] address of the 5 bytes buffer
+ Output   : -
+============================================================================= */
+void Restore_Hook(unsigned int hook, char* slot) __naked
+{
+hook;	//HL
+slot;	//DE
+__asm
+	ld   A,I           ;P/V = IFF2 (interrupts enabled)
+	jp   PE,1$
+	ld   A,I           ;NMOS Z80: read again if an interrupt was accepted
+1$:
+	di
+	push AF
+
+	ex   DE,HL
+	ld   BC,#HOOK_SIZE
+	ldir
+
+	pop  AF
+	jp   PO,2$         ;IF interrupts were disabled THEN do not enable
+	ei
+2$:
+	HOOK_CHANGED
+__endasm;
+}
+
+
+
+/* =============================================================================
+ Disable_Hook
+
+ Function : Disable a hook (Add a ret on the hook and clear the address,
+            so that Resume_Hook does not enable it).
+            The 3 first bytes of the hook are C9 C9 C9.
+ Input    : [hook] hook address
+ Output   : -
+============================================================================= */
+void Disable_Hook(unsigned int hook) __naked
+{
+hook;	//HL
+__asm
+	ld   A,I           ;P/V = IFF2 (interrupts enabled)
+	jp   PE,1$
+	ld   A,I           ;NMOS Z80: read again if an interrupt was accepted
+1$:
+	di
+	push AF
+
+	ld   (HL),#0xC9    ;ret
+	inc  HL
+	ld   (HL),#0xC9    ;clear the address (Resume_Hook does not enable it)
+	inc  HL
+	ld   (HL),#0xC9
+
+	pop  AF
+	jp   PO,2$         ;IF interrupts were disabled THEN do not enable
+	ei
+2$:
+	HOOK_CHANGED
+__endasm;
+}
+
+
+
+/* =============================================================================
+ Pause_Hook
+
+ Function : Pause a hook with a JP (change the JP opcode to a RET).
+            Other hooks (RET, RST 30h) are not changed.
+            The address of the function is kept.
+ Input    : [hook] hook address
+ Output   : -
+============================================================================= */
+void Pause_Hook(unsigned int hook) __naked
+{
+hook;	//HL
+__asm
+	ld   A,(HL)
+	cp   #0xC3
+	ret  NZ            ;IF it is not a JP (RET, RST 30h) THEN do not change it
+	ld   (HL),#0xC9    ;ret (one byte: no need to disable the interrupts)
+	HOOK_CHANGED
+__endasm;
+}
+
+
+
+/* =============================================================================
+ Resume_Hook
+
+ Function : Resume a hook paused with Pause_Hook (change the RET to JP).
+            Only a RET followed by the address of a function is changed:
+            a hook not installed (RET, 0xC9C9) is not changed.
+ Input    : [hook] hook address
+ Output   : -
+============================================================================= */
+void Resume_Hook(unsigned int hook) __naked
+{
+hook;	//HL
+__asm
+	ld   A,(HL)
+	cp   #0xC9
+	ret  NZ            ;IF it is not paused (JP, RST 30h) THEN exit
+	inc  HL
+	ld   A,(HL)
+	inc  HL
+	cp   (HL)
+	jr   NZ,1$
+	cp   #0xC9
+	ret  Z             ;IF the address is 0xC9C9 (not installed) THEN exit
+1$:
+	dec  HL
+	dec  HL
+	ld   (HL),#0xC3    ;jp
+	HOOK_CHANGED
+__endasm;
+}
+
+
+
+/* =============================================================================
+ Save_TIMI
+
+ Function : Save TIME hook vector
+ Input    : -
+ Output   : -
+============================================================================= */
+void Save_TIMI(void) __naked
+{
+__asm
+	ld   HL,#HTIMI
+	ld   DE,#_OLD_TIMI
+	jp   _Save_Hook
+__endasm;
+}
+
+
+
 /* =============================================================================
  Install_TIMI
 
@@ -70,15 +273,9 @@ void Install_TIMI(void (*func)(void)) __naked
 {
 func;	//HL
 __asm
-  
-  ; Set new TIMI vector
-  di
-  ld   A,#0xC3       ;add a JP
-  ld   (#HTIMI),A
-  ld   (#HTIMI+1),HL
-  ei
-  
-  ret
+	ex   DE,HL
+	ld   HL,#HTIMI
+	jp   _Install_Hook
 __endasm;
 }
 
@@ -94,15 +291,9 @@ __endasm;
 void Restore_TIMI(void) __naked
 {
 __asm
-	di
-  
-    ld	 HL,#_OLD_TIMI
-	ld	 DE,#HTIMI
-	ld	 BC,#5
-	ldir
-  
-	ei
-	ret
+	ld   HL,#HTIMI
+	ld   DE,#_OLD_TIMI
+	jp   _Restore_Hook
 __endasm;
 }
 
@@ -112,18 +303,53 @@ __endasm;
 /* =============================================================================
  Disable_TIMI
 
- Function : Disable the TIMI hook (Add a ret on the hook).
+ Function : Disable the TIMI hook (Add a ret on the hook and clear the
+            address, so that Resume_TIMI does not enable it).
+            The 3 first bytes of the hook are C9 C9 C9.
  Input    : -
  Output   : -
 ============================================================================= */
 void Disable_TIMI(void) __naked
 {
 __asm
-    di
-	ld  A,#0xC9     ; ret
-    ld  (#HTIMI),A
-    ei    
-    ret
+	ld   HL,#HTIMI
+	jp   _Disable_Hook
+__endasm;
+}
+
+
+
+/* =============================================================================
+ Pause_TIMI
+
+ Function : Pause the TIMI hook (change the JP opcode to a RET).
+            Other hooks (RET, RST 30h) are not changed.
+ Input    : -
+ Output   : -
+============================================================================= */
+void Pause_TIMI(void) __naked
+{
+__asm
+	ld   HL,#HTIMI
+	jp   _Pause_Hook
+__endasm;
+}
+
+
+
+/* =============================================================================
+ Resume_TIMI
+
+ Function : Resume the TIMI hook paused with Pause_TIMI. Only a RET
+            followed by the address of a function is changed to a JP.
+ Input    : -
+ Output   : -
+============================================================================= */
+void Resume_TIMI(void) __naked
+{
+__asm
+	ld   HL,#HTIMI
+	jp   _Resume_Hook
 __endasm;
 }
 
@@ -139,15 +365,9 @@ __endasm;
 void Save_KEYI(void) __naked
 {
 __asm
-	di
-  
-	ld	 HL,#HKEYI
-	ld	 DE,#_OLD_HKEYI
-	ld	 BC,#5
-	ldir
-  
-	ei
-	ret
+	ld   HL,#HKEYI
+	ld   DE,#_OLD_HKEYI
+	jp   _Save_Hook
 __endasm;
 }
 
@@ -164,14 +384,9 @@ void Install_KEYI(void (*func)(void)) __naked
 {
 func; //HL
 __asm
-  
-	di
-	ld   A,#0xC3       ;add a JP
-	ld   (#HKEYI),A
-	ld   (#HKEYI+1),HL
-	ei
-	
-	ret
+	ex   DE,HL
+	ld   HL,#HKEYI
+	jp   _Install_Hook
 __endasm;
 }
 
@@ -187,15 +402,9 @@ __endasm;
 void Restore_KEYI(void) __naked
 {
 __asm
-	di
-  
-    ld	 HL,#_OLD_HKEYI
-	ld	 DE,#HKEYI
-	ld	 BC,#5
-	ldir
-  
-	ei
-	ret
+	ld   HL,#HKEYI
+	ld   DE,#_OLD_HKEYI
+	jp   _Restore_Hook
 __endasm;
 }
 
@@ -205,17 +414,52 @@ __endasm;
 /* =============================================================================
  Disable_KEYI
 
- Function : Disable the KEYI hook (Add a ret on the hook).
+ Function : Disable the KEYI hook (Add a ret on the hook and clear the
+            address, so that Resume_KEYI does not enable it).
+            The 3 first bytes of the hook are C9 C9 C9.
  Input    : -
  Output   : -
 ============================================================================= */
 void Disable_KEYI(void) __naked
 {
 __asm
-    di
-	ld  A,#0xC9     ; ret
-    ld  (#HKEYI),A
-    ei    
-    ret
+	ld   HL,#HKEYI
+	jp   _Disable_Hook
+__endasm;
+}
+
+
+
+/* =============================================================================
+ Pause_KEYI
+
+ Function : Pause the KEYI hook (change the JP opcode to a RET).
+            Other hooks (RET, RST 30h) are not changed.
+ Input    : -
+ Output   : -
+============================================================================= */
+void Pause_KEYI(void) __naked
+{
+__asm
+	ld   HL,#HKEYI
+	jp   _Pause_Hook
 __endasm;
-}
\ No newline at end of file
+}
+
+
+
+/* =============================================================================
+ Resume_KEYI
+
+ Function : Resume the KEYI hook paused with Pause_KEYI. Only a RET
+            followed by the address of a function is changed to a JP.
+ Input    : -
+ Output   : -
+============================================================================= */
+void Resume_KEYI(void) __naked
+{
+__asm
+	ld   HL,#HKEYI
+	jp   _Resume_Hook
+__endasm;
+}
@@ -0,0 +1,293 @@
+/* =============================================================================
+Z80 interrupt M1 TIMI Subscribers MSX SDCC Library (fR3eL Project)
+Version: 1.1 (17/10/2026)
+Author: mvac7/303bcn
+Architecture: MSX
+Format: C Object (SDCC .rel)
+Programming language: C and Z80 assembler
+
+fR3eL Project
+https://github.com/mvac7/SDCC_MSX_fR3eL
+
+Description:
+List of VBLANK functions behind the TIMI hook. Each module subscribes and
+unsubscribes its function at any moment, without coordinating with the others.
+
+The list is not walked in the interrupt. Each node contains the code that
+calls its function and jumps to the next node, so the hook executes:
+
+  list:           push AF
+                  jp   node1
+  node1:          call func1
+                  jp   node2
+  ...
+  nodeN:          call funcN
+                  jp   list+4
+  list+4:         pop  AF
+                  (5 bytes of the old hook)
+
+The list (TIMI_SUBS_SIZE bytes) and the nodes are given by the program, in
+page 3: they are executed from the hook.
+
+Each node also saves the address of the JP operand that points to it, so that
+it can be unlinked without walking the list. Both operations are a few
+writes with the interrupts disabled: its cost does not depend on the number of
+subscribers.
+
+History of versions:
+- v1.1 (17/10/2026) List in a buffer of the program (page 3)
+- v1.0 (17/10/2026) First version
+============================================================================= */
+
+#include "../include/interruptM1_Hooks.h"
+#include "../include/interruptM1_Subscribers.h"
+
+
+#define PUSHAF_CODE	0xF5
+#define POPAF_CODE	0xF1
+#define JP_CODE		0xC3
+#define RET_CODE	0xC9
+
+
+#define SUBS_END	4	//pop AF + old hook (5), after push AF + JP first node
+
+
+char* TIMI_SUBS;		//list of subscribers (buffer of the program)
+
+
+
+
+/* =============================================================================
+ Init_Subscribers
+
+ Function : Initialize the list of subscribers (empty)
+ Input    : [list] address of a TIMI_SUBS_SIZE bytes buffer in page 3
+ Output   : -
+============================================================================= */
+void Init_Subscribers(char* list)
+{
+	TIMI_SUBS = list;
+
+	list[0] = PUSHAF_CODE;
+	list[1] = JP_CODE;
+	*(unsigned int*)&list[2] = (unsigned int)&list[SUBS_END];
+
+	list[SUBS_END] = POPAF_CODE;
+	list[SUBS_END + 1] = RET_CODE;
+}
+
+
+
+/* =============================================================================
+ Install_Subscribers
+
+ Function : Save the TIMI hook and set the list of subscribers on it.
+            The old hook is executed after the subscribers.
+ Input    : -
+ Output   : -
+============================================================================= */
+void Install_Subscribers(void)
+{
+	Save_Hook(HOOK_TIMI, &TIMI_SUBS[SUBS_END + 1]);
+	Install_Hook(HOOK_TIMI, (void (*)(void))TIMI_SUBS);
+}
+
+
+
+/* =============================================================================
+ Restore_Subscribers
+
+ Function : Restore the TIMI hook saved by Install_Subscribers
+ Input    : -
+ Output   : -
+============================================================================= */
+void Restore_Subscribers(void)
+{
+	Restore_Hook(HOOK_TIMI, &TIMI_SUBS[SUBS_END + 1]);
+}
+
+
+
+/* =============================================================================
+ Subscribe_TIMI
+
+ Function : Add a function to the list of subscribers (it is executed first).
+            It can be called with the interrupts enabled.
+ Input    : [TIMI_SUBSCRIBER*] node of the subscriber
+            [func] Function address
+ Output   : -
+============================================================================= */
+void Subscribe_TIMI(TIMI_SUBSCRIBER* node, void (*func)(void)) __naked
+{
+node;	//HL
+func;	//DE
+__asm
+  ld   (HL),#0xCD       ;CALL func
+  inc  HL
+  ld   (HL),E
+  inc  HL
+  ld   (HL),D
+  inc  HL
+  ld   (HL),#0xC3       ;JP next
+  inc  HL
+  ld   B,H
+  ld   C,L              ;BC = JP operand of the node
+
+  ld   A,I              ;P/V = IFF2 (interrupts enabled)
+  jp   PE,1$
+  ld   A,I              ;NMOS Z80: read again if an interrupt was accepted
+1$:
+  di
+  push AF
+
+  ld   HL,(#_TIMI_SUBS)
+  inc  HL
+  inc  HL               ;HL = JP operand of the list
+  ld   E,(HL)
+  inc  HL
+  ld   D,(HL)           ;DE = first node
+  dec  HL
+  push HL
+  ld   H,B
+  ld   L,C
+  ld   (HL),E
+  inc  HL
+  ld   (HL),D           ;next = first node
+  inc  HL
+  ex   (SP),HL          ;HL = JP operand of the list
+  ex   DE,HL            ;HL = first node
+  ex   (SP),HL          ;HL = link of the node
+  ld   (HL),E
+  inc  HL
+  ld   (HL),D           ;link = JP operand of the list
+
+  pop  HL               ;first node
+  push DE
+  inc  DE
+  inc  DE               ;DE = end of the list (pop AF)
+  or   A
+  sbc  HL,DE
+  jr   Z,2$             ;IF the list is empty THEN there is no node to update
+  add  HL,DE
+  ld   DE,#6
+  add  HL,DE
+  ld   (HL),C
+  inc  HL
+  ld   (HL),B           ;link of the old first node = JP operand of the node
+
+2$:
+  pop  HL               ;JP operand of the list
+  dec  BC
+  dec  BC
+  dec  BC
+  dec  BC               ;BC = node
+  ld   (HL),C
+  inc  HL
+  ld   (HL),B           ;the node is executed from here
+
+  pop  AF
+  ret  PO               ;IF interrupts were disabled THEN exit
+  ei
+  ret
+__endasm;
+}
+
+
+
+/* =============================================================================
+ Unsubscribe_TIMI
+
+ Function : Remove a subscriber from the list.
+            It can be called with the interrupts enabled or from a subscriber.
+ Input    : [TIMI_SUBSCRIBER*] node of a subscribed function
+ Output   : -
+============================================================================= */
+void Unsubscribe_TIMI(TIMI_SUBSCRIBER* node) __naked
+{
+node;	//HL
+__asm
+  ld   A,I              ;P/V = IFF2 (interrupts enabled)
+  jp   PE,1$
+  ld   A,I              ;NMOS Z80: read again if an interrupt was accepted
+1$:
+  di
+  push AF
+
+  ld   DE,#4
+  add  HL,DE
+  ld   E,(HL)
+  inc  HL
+  ld   D,(HL)           ;DE = next node
+  inc  HL
+  ld   C,(HL)
+  inc  HL
+  ld   B,(HL)           ;BC = JP operand that points to the node
+
+  ld   A,E
+  ld   (BC),A
+  inc  BC
+  ld   A,D
+  ld   (BC),A           ;the previous JP skips the node
+  dec  BC
+
+  ex   DE,HL
+  ld   DE,(#_TIMI_SUBS)
+  inc  DE
+  inc  DE
+  inc  DE
+  inc  DE               ;DE = end of the list (pop AF)
+  or   A
+  sbc  HL,DE
+  jr   Z,2$             ;IF it was the last node THEN exit
+  add  HL,DE
+  ld   DE,#6
+  add  HL,DE
+  ld   (HL),C
+  inc  HL
+  ld   (HL),B           ;link of the next node = link of the node
+
+2$:
+  pop  AF
+  ret  PO               ;IF interrupts were disabled THEN exit
+  ei
+  ret
+__endasm;
+}
+
+
+
+/* =============================================================================
+ Pause_Subscriber
+
+ Function : Pause a subscriber without removing it from the list.
+            The CALL is changed to a LD HL,nn, that skips the address of the
+            function. It is one byte, so the interrupts are not disabled.
+ Input    : [TIMI_SUBSCRIBER*] node of a subscribed function
+ Output   : -
+============================================================================= */
+void Pause_Subscriber(TIMI_SUBSCRIBER* node) __naked
+{
+node;	//HL
+__asm
+  ld   (HL),#0x21       ;ld HL,nn
+  ret
+__endasm;
+}
+
+
+
+/* =============================================================================
+ Resume_Subscriber
+
+ Function : Resume a subscriber paused with Pause_Subscriber
+ Input    : [TIMI_SUBSCRIBER*] node of a subscribed function
+ Output   : -
+============================================================================= */
+void Resume_Subscriber(TIMI_SUBSCRIBER* node) __naked
+{
+node;	//HL
+__asm
+  ld   (HL),#0xCD       ;call
+  ret
+__endasm;
+}
@@ -0,0 +1,88 @@
+/* =============================================================================
+Z80 interrupt Mode 2 MSX SDCC Library (fR3eL Project)
+Library with basic functions to control the Interrupt Service Routine (ISR) for
+Z80 Mode 2 interrupts on MSX system.
+https://github.com/mvac7/SDCC_MSX_fR3eL
+============================================================================= */
+
+#ifndef  __INTERRUPT_M2_ISR_H__
+#define  __INTERRUPT_M2_ISR_H__
+
+
+#ifndef _Z80interruptDefs_
+#define _Z80interruptDefs_
+
+#define  DisableI         __asm di __endasm
+#define  EnableI          __asm ei __endasm
+
+#define  HALT             __asm halt __endasm
+
+#endif
+
+
+
+
+/* =============================================================================
+ Save_IM2
+
+ Function : Save the I register of the Z80
+ Input    : -
+ Output   : -
+============================================================================= */
+void Save_IM2(void);
+
+
+
+/* =============================================================================
+ Install_IM2
+
+ Function : Build the vector table at 0xD000 (IM2_TABLE, 0xD000-0xD1D3, 468
+            bytes),
+            set the ISR and switch to Mode 2
+ Input    : Function address
+ Output   : -
+============================================================================= */
+void Install_IM2(void (*isr)(void));
+
+
+
+/* =============================================================================
+ Install_IM2_At
+
+ Function : Build the vector table in an area of the program, set the ISR and
+            switch to Mode 2
+ Input    : [isr] Function address
+            [table] address of the area (0xnn00, page-aligned, in page 3, up to
+                    0xF100). It uses 259+mm bytes: 0xnn00 to 0xmmmm+2
+                    (mm = nn+1)
+ Output   : 1 = installed; 0 = invalid address (0xF200 or higher)
+============================================================================= */
+char Install_IM2_At(void (*isr)(void), unsigned int table);
+
+
+
+/* =============================================================================
+ Restore_IM2
+
+ Function : Restore the I register and return to Mode 1
+ Input    : -
+ Output   : -
+============================================================================= */
+void Restore_IM2(void);
+
+
+
+/* =============================================================================
+ Disable_IM2
+
+ Function : Disable ISR
+            Install an ISR with the minimum code so as not to block the Z80.
+ Input    : -
+ Output   : -
+============================================================================= */
+void Disable_IM2(void);
+
+
+
+
+#endif
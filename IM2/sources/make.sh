@@ -0,0 +1,9 @@
+#!/bin/sh
+# Build of the objects on Linux/macOS (same as MAKEFILE.BAT)
+set -e
+cd "$(dirname "$0")"
+# get SDCC version
+sdcc -v
+mkdir -p build
+echo Compiling Object
+sdcc -mz80 -c -o build/ src/interruptM2_ISR.c
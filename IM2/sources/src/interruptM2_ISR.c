@@ -0,0 +1,214 @@
+/* =============================================================================
+Z80 interrupt Mode 2 MSX SDCC Library (fR3eL Project)
+Version: 1.2 (17/10/2026)
+Author: mvac7/303bcn
+Architecture: MSX
+Format: C Object (SDCC .rel)
+Programming language: C and Z80 assembler
+Compiler: SDCC 4.4 or newer
+
+fR3eL Project
+https://github.com/mvac7/SDCC_MSX_fR3eL
+
+Description:
+Library with basic functions to control the Interrupt Service Routine (ISR) for
+Z80 Mode 2 interrupts on MSX system.
+It does not need RAM on page 0, so it can be used in ROM cartridges with the
+BIOS visible on page 0.
+
+The MSX does not put a vector on the data bus during the interrupt acknowledge,
+so a table of 257 bytes with the same value is built on a page-aligned address.
+Whatever the value read from the bus, the Z80 jumps to the address formed by
+two equal bytes (V*257), where a JP to the ISR is placed.
+
+With a table at 0xnn00, the area 0xnn00-0xmmmm+2 (mm = nn+1, 259+mm bytes, 468
+with 0xD000) is used: the table, free bytes and the JP. The program must
+reserve it.
+Install_IM2_At receives the address of the area. Install_IM2 uses IM2_TABLE
+(0xD000 by default, it can be changed with -DIM2_TABLE=0xnn00).
+
+History of versions:
+- v1.2 (17/10/2026) I register from the address of the table and table up to
+                    0xF100 (out of the system work area)
+- v1.1 (17/10/2026) Address of the table given by the program (Install_IM2_At)
+- v1.0 (17/10/2026) First version
+============================================================================= */
+
+#include "../include/interruptM2_ISR.h"
+
+
+#ifndef IM2_TABLE
+#define IM2_TABLE	0xD000	//Interrupt vectors table (page-aligned, page 3)
+#endif
+
+
+char OLD_I;
+
+
+void IM2_empty(void);
+
+
+
+
+/* =============================================================================
+ Save_IM2
+
+ Function : Save the I register of the Z80
+ Input    : -
+ Output   : -
+============================================================================= */
+void Save_IM2(void) __naked
+{
+__asm
+  ld   A,I
+  ld   (#_OLD_I),A
+  ret
+__endasm;
+}
+
+
+
+/* =============================================================================
+ Install_IM2
+
+ Function : Build the vector table, set the ISR and switch to Mode 2
+ Input    : Function address
+ Output   : -
+============================================================================= */
+void Install_IM2(void (*isr)(void)) __naked
+{
+isr;	//HL
+__asm
+  ld   DE,#IM2_TABLE
+  jp   _Install_IM2_At
+__endasm;
+}
+
+
+
+/* =============================================================================
+ Install_IM2_At
+
+ Function : Build the vector table in an area of the program, set the ISR and
+            switch to Mode 2
+            The table is filled with the interrupts enabled. They are only
+            disabled to write the JP, load I and switch to Mode 2.
+ Input    : [isr] Function address
+            [table] address of the area (0xnn00, page-aligned, in page 3, up to
+                    0xF100). It uses 259+mm bytes: 0xnn00 to 0xmmmm+2
+                    (mm = nn+1)
+ Output   : 1 = installed; 0 = invalid address (0xF200 or higher)
+============================================================================= */
+char Install_IM2_At(void (*isr)(void), unsigned int table) __naked
+{
+isr;	//HL
+table;	//DE
+__asm
+  ld   A,D
+  cp   #0xF2
+  jr   C,1$
+  xor  A             ;0xF200 or higher: the area reaches the system work area
+  ret
+1$:
+  push HL            ;ISR
+  push DE            ;D = high byte of the table
+
+  ; vector table (257 bytes with 0xmm), with the interrupts enabled
+  inc  A
+  ld   H,D
+  ld   L,#0
+  ld   (HL),A
+  ld   E,L
+  inc  E
+  ld   BC,#256
+  ldir
+  ld   L,H           ;HL = 0xmmmm
+  pop  BC            ;B = high byte of the table
+  pop  DE            ;ISR
+
+  ld   A,I           ;P/V = IFF2 (interrupts enabled)
+  jp   PE,2$
+  ld   A,I           ;NMOS Z80: read again if an interrupt was accepted
+2$:
+  di
+  push AF
+
+  ; JP to the ISR at 0xmmmm
+  ld   (HL),#0xC3
+  inc  HL
+  ld   (HL),E
+  inc  HL
+  ld   (HL),D
+
+  ld   A,B
+  ld   I,A
+  im   2
+
+  pop  AF
+  ld   A,#1
+  ret  PO           ;IF interrupts were disabled THEN exit
+  ei
+  ret
+__endasm;
+}
+
+
+
+/* =============================================================================
+ Restore_IM2
+
+ Function : Restore the I register and return to Mode 1
+ Input    : -
+ Output   : -
+============================================================================= */
+void Restore_IM2(void) __naked
+{
+__asm
+  ld   A,I           ;P/V = IFF2 (interrupts enabled)
+  jp   PE,1$
+  ld   A,I           ;NMOS Z80: read again if an interrupt was accepted
+1$:
+  di
+  push AF
+  ld   A,(#_OLD_I)
+  ld   I,A
+  im   1
+  pop  AF
+  ret  PO           ;IF interrupts were disabled THEN exit
+  ei
+  ret
+__endasm;
+}
+
+
+
+/* =============================================================================
+ Disable_IM2
+
+ Function : Disable ISR
+            Install an ISR with the minimum code so as not to block the Z80.
+ Input    : -
+ Output   : -
+============================================================================= */
+void Disable_IM2(void)
+{
+	Install_IM2(IM2_empty);
+}
+
+
+
+/*
+	Minimum code to be executed by an ISR of an M2 interrupt, necessary for it to work correctly.
+*/
+void IM2_empty(void) __naked
+{
+__asm
+  push   AF
+  in     A,(0x99)        ;read if VDP interrupt and Disable interrupt call to CPU
+  ld     (0xF3E7),A      ;save VDP reg#0 in STATFL system variable
+  pop    AF
+
+  ei                     ;Enable Interrupts
+  ret
+__endasm;
+}
@@ -0,0 +1,10 @@
+#!/bin/sh
+# Warns if the application uses the alternate registers (for ISR_Shadow).
+# Checks the assembler files (.asm) generated by SDCC (same as CHECK_ALTREGS.BAT)
+# Usage: sh check_altregs.sh folder_with_asm_files
+dir="${1:?Usage: check_altregs.sh folder_with_asm_files}"
+if grep -n -i -E '^[[:space:]]*(exx|ex[[:space:]]+af[[:space:]]*,[[:space:]]*af)' "$dir"/*.asm; then
+  echo "WARNING: the alternate registers are used. Do not install ISR_Shadow."
+  exit 1
+fi
+echo "The alternate registers are not used."
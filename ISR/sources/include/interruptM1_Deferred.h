@@ -0,0 +1,69 @@
+/* =============================================================================
+Z80 interrupt Mode 1 Deferred work MSX SDCC Library (fR3eL Project)
+Queue of work posted by the interrupt handlers and executed by the main loop
+with interrupts enabled.
+https://github.com/mvac7/SDCC_MSX_fR3eL
+============================================================================= */
+
+#ifndef  __INTERRUPT_M1_DEFERRED_H__
+#define  __INTERRUPT_M1_DEFERRED_H__
+
+
+// Size of the queue (power of 2). The queue holds DEFER_SIZE-1 items.
+#ifndef DEFER_SIZE
+#define DEFER_SIZE	16
+#endif
+
+
+typedef void (*DEFER_FUNC)(unsigned int);
+
+typedef struct {
+	DEFER_FUNC func;
+	unsigned int arg;
+} DEFER_ITEM;
+
+
+// Number of items not posted because the queue was full (up to 255).
+extern char DEFER_overflow;
+
+
+
+
+/* =============================================================================
+ Init_Deferred
+
+ Function : Empty the queue
+ Input    : -
+ Output   : -
+============================================================================= */
+void Init_Deferred(void);
+
+
+
+/* =============================================================================
+ Post_Deferred
+
+ Function : Add a work item to the queue. 
+            Only call it from the interrupt (TIMI/KEYI functions or ISR).
+ Input    : [func] Function address
+            [arg] value for the function
+ Output   : 1 = posted; 0 = the queue is full
+============================================================================= */
+char Post_Deferred(DEFER_FUNC func, unsigned int arg);
+
+
+
+/* =============================================================================
+ RunDeferred
+
+ Function : Execute the work items of the queue, with interrupts enabled.
+            Call it from the main loop (after HALT).
+ Input    : -
+ Output   : -
+============================================================================= */
+void RunDeferred(void);
+
+
+
+
+#endif
@@ -0,0 +1,215 @@
+/* =============================================================================
+Z80 interrupt Mode 1 VBLANK Dispatcher MSX SDCC Library (fR3eL Project)
+Table of VBLANK handlers with priorities, executed from the TIMI hook.
+https://github.com/mvac7/SDCC_MSX_fR3eL
+============================================================================= */
+
+#ifndef  __INTERRUPT_M1_DISPATCH_H__
+#define  __INTERRUPT_M1_DISPATCH_H__
+
+
+// Maximum number of handlers (change it when compiling the library)
+#ifndef DISPATCH_MAX
+#define DISPATCH_MAX	8
+#endif
+
+// Port of the memory mapper where the segments of the handlers are selected
+// (0xFE = page 2, 0x8000-0xBFFF)
+#ifndef DISPATCH_SEGMENT_PORT
+#define DISPATCH_SEGMENT_PORT	0xFE
+#endif
+
+#define DISPATCH_NOSEGMENT	0xFF	// the handler does not change the segment
+
+// Bytes of each of the two buffers of generated code (Init_Dispatcher):
+// 70 for the registers, the VDP, the frames counter and the exit, and 38 for
+// each handler
+#define DISPATCH_CODE_SIZE	(70+DISPATCH_MAX*38)
+
+
+// Options of the ISR generated by Install_DispatcherISR
+#define DISPATCH_ISR_KEYI		0x01	// calls the KEYI hook
+#define DISPATCH_ISR_ALTREGS	0x02	// saves the alternate registers
+#define DISPATCH_ISR_INDEXREGS	0x04	// saves IX (IY is always saved)
+#define DISPATCH_ISR_MODE		0x80	// (internal) the ISR is generated
+
+
+typedef struct {
+	void (*func)(void);	// handler function
+	char priority;		// higher values are executed first
+	char slot;			// index of the counter of the divider
+	char divider;		// executed one of each N frames
+	char phase;			// offset in frames
+	char segment;		// segment of the memory mapper (DISPATCH_NOSEGMENT)
+	char paused;		// 1 = not executed (Pause_Handler)
+	char* call;			// CALL of the handler in the generated code
+} DISPATCH_ENTRY;
+
+
+typedef struct {
+	unsigned int cost;	// T-states of the handler (0 = out of the budget)
+	char deferred;		// 1 = it did not fit in the last frame
+} DISPATCH_BUDGET;
+
+
+// Frames counter. Incremented by the dispatcher in each VBLANK.
+// The dividers are aligned with it (Set_HandlerDivider), also when it wraps.
+extern unsigned int DISPATCH_frames;
+
+// Number of times that a handler has been deferred to the next frame
+// (Set_FrameBudget). It can be cleared by the program.
+extern unsigned int DISPATCH_deferred;
+
+
+
+
+/* =============================================================================
+ Init_Dispatcher
+
+ Function : Initialize the table of handlers (empty). The generated code
+            only counts the frames.
+            The code is executed from the TIMI hook or from 0x0038: the buffer
+            must be in page 3 (0xC000-0xFFFF).
+ Input    : [code] address of a buffer of 2*DISPATCH_CODE_SIZE bytes in page 3
+            for the generated code
+ Output   : -
+============================================================================= */
+void Init_Dispatcher(char* code);
+
+
+
+/* =============================================================================
+ Install_Dispatcher
+
+ Function : Set the dispatcher in the TIMI hook with Install_TIMI
+            (requires the interruptM1_Hooks or interruptM1_HooksAuto object)
+ Input    : -
+ Output   : -
+============================================================================= */
+void Install_Dispatcher(void);
+
+
+
+/* =============================================================================
+ Install_DispatcherISR
+
+ Function : Generate an ISR with the handlers and set it in the ISR vector
+            (0x0038). It is generated again each time the table changes.
+            The hooks are not called, unless it is selected.
+ Input    : [options] DISPATCH_ISR_KEYI, DISPATCH_ISR_ALTREGS and/or
+            DISPATCH_ISR_INDEXREGS (0 = only the main registers and IY
+            are saved)
+ Output   : -
+============================================================================= */
+void Install_DispatcherISR(char options);
+
+
+
+/* =============================================================================
+ Add_Handler
+
+ Function : Add a function to the table of handlers.
+            Handlers with the same priority are executed in order of addition.
+ Input    : [func] Function address
+            [priority] higher values are executed first
+ Output   : 1 = added; 0 = the table is full
+============================================================================= */
+char Add_Handler(void (*func)(void), char priority);
+
+
+
+/* =============================================================================
+ Remove_Handler
+
+ Function : Remove a function from the table of handlers
+ Input    : [func] Function address
+ Output   : 1 = removed; 0 = not found
+============================================================================= */
+char Remove_Handler(void (*func)(void));
+
+
+
+/* =============================================================================
+ Set_HandlerDivider
+
+ Function : Execute a handler only on the frames where
+            (frame + phase) % divider == 0
+            Use different phases to spread the handlers on different frames.
+ Input    : [func] Function address
+            [divider] 1 = every frame
+            [phase] offset in frames
+ Output   : 1 = done; 0 = not found
+============================================================================= */
+char Set_HandlerDivider(void (*func)(void), char divider, char phase);
+
+
+
+/* =============================================================================
+ Set_HandlerSegment
+
+ Function : Select a segment of the memory mapper (MSX-DOS2) before executing
+            a handler. The segment of the program is selected again after
+            the handler.
+ Input    : [func] Function address
+            [segment] segment number or DISPATCH_NOSEGMENT
+ Output   : 1 = done; 0 = not found
+============================================================================= */
+char Set_HandlerSegment(void (*func)(void), char segment);
+
+
+
+/* =============================================================================
+ Set_FrameBudget
+
+ Function : Set the T-states of each frame for the handlers with a cost
+            (Set_HandlerCost). They are executed in order of priority while
+            their cost fits; the others are deferred to the next frame, where
+            they are executed even if they do not fit.
+ Input    : [tstates] 0 = no budget (all the handlers are executed)
+ Output   : -
+============================================================================= */
+void Set_FrameBudget(unsigned int tstates);
+
+
+
+/* =============================================================================
+ Set_HandlerCost
+
+ Function : Declare the cost of a handler in T-states, to execute it only
+            while it fits in the frame budget
+ Input    : [func] Function address
+            [cost] T-states (0 = always executed, out of the budget)
+ Output   : 1 = done; 0 = not found
+============================================================================= */
+char Set_HandlerCost(void (*func)(void), unsigned int cost);
+
+
+
+/* =============================================================================
+ Pause_Handler
+
+ Function : Pause a handler without removing it from the table.
+            Only the opcode of its CALL is changed (one byte), so it can be
+            called with the interrupts enabled or from a handler.
+            Add_Handler, Remove_Handler and the generation of the code
+            change the table in a critical section.
+ Input    : [func] Function address
+ Output   : 1 = done; 0 = not found
+============================================================================= */
+char Pause_Handler(void (*func)(void));
+
+
+
+/* =============================================================================
+ Resume_Handler
+
+ Function : Resume a handler paused with Pause_Handler
+ Input    : [func] Function address
+ Output   : 1 = done; 0 = not found
+============================================================================= */
+char Resume_Handler(void (*func)(void));
+
+
+
+
+#endif
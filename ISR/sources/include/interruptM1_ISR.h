@@ -20,12 +20,23 @@ https://github.com/mvac7/SDCC_MSX_fR3eL
 #endif
 
 
+typedef void (*ISR_FUNC)(void);
+
+
+// Nesting level of the critical sections (EnterCritical). 0 = not in a
+// critical section. Save_ISR clears it.
+extern char ISR_critical;
+
+// 1 while the TIMI hook of an ISR compiled with ISR_NESTED (ISR_Nested) is
+// running. Init_ISR_Nested clears it.
+extern char ISR_busy;
+
 
 
 /* =============================================================================
  Save_ISR
 
- Function : Save Old ISR vector
+ Function : Save Old ISR vector and initialize the counter of EnterCritical
  Input    : -
  Output   : -
 ============================================================================= */
@@ -67,6 +78,32 @@ void Disable_ISR(void);
 
 
 
+/* =============================================================================
+ EnterCritical
+
+ Function : Disable interrupts and enter a critical section.
+            The critical sections can be nested (ISR_critical counts them):
+            only the ExitCritical of the outer one enables the interrupts
+            again, and only if they were enabled when it was entered.
+ Input    : -
+ Output   : -
+============================================================================= */
+void EnterCritical(void);
+
+
+
+/* =============================================================================
+ ExitCritical
+
+ Function : Exit a critical section entered with EnterCritical.
+            The outer one enables the interrupts if they were enabled.
+ Input    : -
+ Output   : 1 = done; 0 = not in a critical section (nothing is done)
+============================================================================= */
+char ExitCritical(void);
+
+
+
 /* =============================================================================
 ## Basic ISR for M1 interrupt of Z80
 
@@ -74,12 +111,152 @@ void Disable_ISR(void);
 * Calls the two hooks of the system: TIMI (VBLANK) and KEYI
 
 Note: 
-  You can optimize it, commenting on those records that you know you don't use 
-  (such as alternate records) or removing the KEYI hook. 
+  If you do not need all this work, use one of the following variants or 
+  generate your own with the interruptM1_ISRvariant.c template.
 ============================================================================= */
 void ISR_Basic(void);
 
 
 
+/* =============================================================================
+## ISR variants for M1 interrupt of Z80
+
+Generated from the interruptM1_ISRvariant.c template. 
+Each one is in its own object (.rel), link only the one you use.
+
+* ISR_Basic_NoAlt : Calls KEYI and TIMI. Does not save the alternate registers.
+* ISR_TIMI        : Only calls TIMI. Saves all Z80 registers.
+* ISR_TIMI_NoAlt  : Only calls TIMI. Does not save the alternate registers.
+* ISR_KEYI        : Only calls KEYI. Saves all Z80 registers.
+* ISR_NoHooks     : Does not call any hook. Only saves AF and updates STATFL.
+* ISR_Line        : As ISR_Basic, and calls LINE_HOOK on the VDP line interrupt
+                    (V9938/V9958. See interruptM1_LineInt.h).
+* ISR_MegaROM     : As ISR_Basic, and restores the banks of the MegaROM on exit
+                    (ASCII8. ISR_MegaROM_SCC for Konami SCC.
+                    See interruptM1_MegaROM.h).
+* ISR_DOS2        : As ISR_Basic, and restores the segments of the memory mapper
+                    in pages 1 and 2 on exit (MSX-DOS2).
+* ISR_Stack       : As ISR_Basic, on its own stack (see interruptM1_Stack.h).
+* ISR_Shadow      : As ISR_Basic, but works on the alternate registers and does
+                    not save any register (nor IX/IY). The program must never
+                    use the alternate registers (see CHECK_ALTREGS.BAT).
+* ISR_Nested      : As ISR_Basic, but enables the interrupts while the TIMI hook
+                    runs, so that the KEYI devices can interrupt it (ISR_busy).
+============================================================================= */
+void ISR_Basic_NoAlt(void);
+void ISR_TIMI(void);
+void ISR_TIMI_NoAlt(void);
+void ISR_KEYI(void);
+void ISR_NoHooks(void);
+void ISR_Line(void);
+void ISR_MegaROM(void);
+void ISR_MegaROM_SCC(void);
+void ISR_DOS2(void);
+void ISR_Stack(void);
+void ISR_Shadow(void);
+void ISR_Nested(void);
+
+
+
+/* =============================================================================
+ Init_ISR_Nested
+
+ Function : Clear ISR_busy. Call it before installing ISR_Nested.
+            (in the object of ISR_Nested)
+ Input    : -
+ Output   : -
+============================================================================= */
+void Init_ISR_Nested(void);
+
+
+
+/* =============================================================================
+ Select_ISR_Auto
+
+ Function : Returns the cheapest ISR for the current state of the hooks
+            (ISR_Basic, ISR_TIMI, ISR_KEYI or ISR_NoHooks).
+            A hook that only contains a RET is not called.
+ Input    : -
+ Output   : ISR Function address
+============================================================================= */
+ISR_FUNC Select_ISR_Auto(void);
+
+
+
+/* =============================================================================
+ Install_ISR_Auto
+
+ Function : Set the cheapest ISR for the current state of the hooks.
+            Link interruptM1_HooksAuto.rel so that the hook functions keep 
+            it updated.
+ Input    : -
+ Output   : -
+============================================================================= */
+void Install_ISR_Auto(void);
+
+
+
+/* =============================================================================
+ Update_ISR_Auto
+
+ Function : If one of the automatic ISRs is installed, replaces it with the
+            cheapest for the current state of the hooks.
+ Input    : -
+ Output   : -
+============================================================================= */
+void Update_ISR_Auto(void);
+
+
+
+// Size in bytes of the relocatable ISR (ISR_Reloc)
+#define  ISR_RELOC_SIZE   45
+
+
+
+/* =============================================================================
+ Install_ISR_Reloc
+
+ Function : Copy the relocatable ISR (ISR_RELOC_SIZE bytes) to an address of
+            page 3 and set it in the ISR vector.
+            The ISR does the same work as ISR_Basic.
+ Input    : [dest] address in RAM (0xC000-0xFFFF)
+ Output   : -
+============================================================================= */
+void Install_ISR_Reloc(char* dest);
+
+
+
+/* =============================================================================
+ Install_TIMI_Direct / Install_KEYI_Direct
+
+ Function : The copy of the ISR made by Install_ISR_Reloc calls the function
+            directly, instead of the hook (saves the JP of the hook).
+            A JP to the function is also set in the hook.
+            Requires Install_ISR_Reloc: if its copy is not the installed ISR
+            (after Restore_ISR), nothing is changed.
+            In this mode, Pause_TIMI, Disable_TIMI, Restore_TIMI... of the
+            Hooks library only change the hook: call Reset_ISR_Direct before.
+ Input    : [func] Function address
+ Output   : [char] 1 = installed; 0 = the ISR of Install_ISR_Reloc is not installed
+============================================================================= */
+char Install_TIMI_Direct(void (*func)(void));
+char Install_KEYI_Direct(void (*func)(void));
+
+
+
+/* =============================================================================
+ Reset_ISR_Direct
+
+ Function : The copy of the ISR calls again the TIMI and KEYI hooks.
+            The hooks are not changed.
+            Requires Install_ISR_Reloc: if its copy is not the installed ISR
+            (after Restore_ISR), nothing is changed.
+ Input    : -
+ Output   : -
+============================================================================= */
+void Reset_ISR_Direct(void);
+
+
+
 
 #endif
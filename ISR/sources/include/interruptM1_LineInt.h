@@ -0,0 +1,65 @@
+/* =============================================================================
+Z80 interrupt Mode 1 VDP Line interrupt MSX SDCC Library (fR3eL Project)
+Control of the line interrupt (IE1) of the V9938/V9958 VDP.
+Requires an ISR compiled with ISR_LINE_INT (ISR_Line).
+https://github.com/mvac7/SDCC_MSX_fR3eL
+============================================================================= */
+
+#ifndef  __INTERRUPT_M1_LINEINT_H__
+#define  __INTERRUPT_M1_LINEINT_H__
+
+
+// Hook of the line interrupt (JP to the function, or RET)
+extern char LINE_HOOK[3];
+
+
+
+
+/* =============================================================================
+ Init_LineInt
+
+ Function : Initialize the hook of the line interrupt (RET).
+            Call it before installing ISR_Line.
+ Input    : -
+ Output   : -
+============================================================================= */
+void Init_LineInt(void);
+
+
+
+/* =============================================================================
+ Install_LineInt
+
+ Function : Set the function of the line interrupt and enable it (IE1)
+ Input    : [func] Function address
+            [line] line number (VDP R#19)
+ Output   : -
+============================================================================= */
+void Install_LineInt(void (*func)(void), char line);
+
+
+
+/* =============================================================================
+ Set_LineInt
+
+ Function : Change the line of the interrupt (VDP R#19)
+ Input    : [line] line number
+ Output   : -
+============================================================================= */
+void Set_LineInt(char line);
+
+
+
+/* =============================================================================
+ Disable_LineInt
+
+ Function : Disable the line interrupt (IE1) and its hook
+ Input    : -
+ Output   : -
+============================================================================= */
+void Disable_LineInt(void);
+
+
+
+
+#endif
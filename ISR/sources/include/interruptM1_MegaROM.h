@@ -0,0 +1,79 @@
+/* =============================================================================
+Z80 interrupt Mode 1 MegaROM banks MSX SDCC Library (fR3eL Project)
+Shadow of the bank registers of the MegaROM mappers, so that an ISR compiled
+with ISR_MEGAROM (ISR_MegaROM) can restore them after the handlers.
+https://github.com/mvac7/SDCC_MSX_fR3eL
+============================================================================= */
+
+#ifndef  __INTERRUPT_M1_MEGAROM_H__
+#define  __INTERRUPT_M1_MEGAROM_H__
+
+
+// Bank registers of the mapper (8K banks: 0x4000, 0x6000, 0x8000, 0xA000)
+// Compile with -DMEGAROM_KONAMI_SCC for the Konami SCC mapper.
+#ifdef MEGAROM_KONAMI_SCC
+#define  MEGAROM_SEL0     0x5000
+#define  MEGAROM_SEL1     0x7000
+#define  MEGAROM_SEL2     0x9000
+#define  MEGAROM_SEL3     0xB000
+#else
+// ASCII8
+#define  MEGAROM_SEL0     0x6000
+#define  MEGAROM_SEL1     0x6800
+#define  MEGAROM_SEL2     0x7000
+#define  MEGAROM_SEL3     0x7800
+#endif
+
+
+// Bank register used by Call_Banked (2 = 0x8000-0x9FFF)
+#ifndef MEGAROM_CALL_PAGE
+#define MEGAROM_CALL_PAGE	2
+#endif
+
+
+// Bank selected in each register. Do not write the registers directly.
+extern char MEGAROM_banks[4];
+
+
+
+
+/* =============================================================================
+ Init_Banks
+
+ Function : Initialize the banks as the mapper at start: 0, 1, 2, 3
+ Input    : -
+ Output   : -
+============================================================================= */
+void Init_Banks(void);
+
+
+
+/* =============================================================================
+ Set_Bank
+
+ Function : Select a bank in a register of the mapper and save it
+ Input    : [page] register of the mapper (0 to 3 = 0x4000 to 0xA000)
+            [bank] bank number
+ Output   : -
+============================================================================= */
+void Set_Bank(char page, char bank);
+
+
+
+/* =============================================================================
+ Call_Banked
+
+ Function : Call a function of a bank, selected in the register
+            MEGAROM_CALL_PAGE (0x8000 by default), and select the previous
+            bank at the end. It can be used from the handlers of the
+            interrupt and from the main program.
+ Input    : [bank] bank number
+            [func] Function address
+ Output   : -
+============================================================================= */
+void Call_Banked(char bank, void (*func)(void));
+
+
+
+
+#endif
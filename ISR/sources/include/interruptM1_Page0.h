@@ -0,0 +1,98 @@
+/* =============================================================================
+Z80 interrupt Mode 1 Page 0 RAM MSX SDCC Library (fR3eL Project)
+For ROM cartridges: switches page 0 to RAM with a minimal vector page, so that
+the ISR of the program is executed instead of the BIOS one.
+https://github.com/mvac7/SDCC_MSX_fR3eL
+============================================================================= */
+
+#ifndef  __INTERRUPT_M1_PAGE0_H__
+#define  __INTERRUPT_M1_PAGE0_H__
+
+
+#include "interruptM1_ISR.h"
+
+
+
+
+/* =============================================================================
+ Init_Page0RAM
+
+ Function : Switch page 0 to the RAM slot of page 3 and build a minimal
+            vector page:
+            RST 00h-28h = RET; 0x001C (CALSLT) = JP Page0_CALSLT
+            0x0030 (CALLF) = JP Page0_CALLF; 0x0038 = JP isr;
+            0x0066 (NMI) = RETN
+            Install the hooks before: the interrupts are enabled again at
+            the end (if they were enabled) and the ISR calls them.
+            If there is no RAM, the BIOS stays in page 0.
+ Input    : [isr] Function address
+ Output   : 1 = page 0 in RAM; 0 = no RAM for page 0
+============================================================================= */
+char Init_Page0RAM(ISR_FUNC isr);
+
+
+
+/* =============================================================================
+ Page0_BIOS
+
+ Function : Switch page 0 to the BIOS (main ROM).
+            Interrupts will be attended by the BIOS ISR.
+ Input    : -
+ Output   : -
+============================================================================= */
+void Page0_BIOS(void);
+
+
+
+/* =============================================================================
+ Page0_RAM
+
+ Function : Switch page 0 to the RAM selected by Init_Page0RAM
+ Input    : -
+ Output   : -
+============================================================================= */
+void Page0_RAM(void);
+
+
+
+/* =============================================================================
+ Page0_CALSLT
+
+ Function : Inter-slot call with page 0 in RAM (for assembler).
+            Switches page 0 to the BIOS, executes CALSLT and switches it
+            again to RAM. Init_Page0RAM places a JP to it at 0x001C, so
+            the calls to CALSLT of other libraries also work.
+ Input    : IY (high byte) slot; IX address; AF, BC, DE, HL for the routine
+ Output   : AF, BC, DE, HL of the routine
+============================================================================= */
+void Page0_CALSLT(void);
+
+
+
+/* =============================================================================
+ Page0_CALLF
+
+ Function : Inter-slot call of RST 30h with page 0 in RAM (for assembler).
+            Init_Page0RAM places a JP to it at 0x0030, so the hooks with an
+            inter-slot call (RST 30h, slot, address) keep working.
+ Input    : slot (1 byte) and address (2 bytes) after the RST 30h;
+            AF, BC, DE, HL for the routine
+ Output   : AF, BC, DE, HL of the routine. Changes IX and IY (as the BIOS).
+============================================================================= */
+void Page0_CALLF(void);
+
+
+
+/* =============================================================================
+ Call_BIOS
+
+ Function : Call a BIOS routine without parameters with page 0 in RAM
+ Input    : [address] address of the BIOS routine
+ Output   : -
+============================================================================= */
+void Call_BIOS(unsigned int address);
+
+
+
+
+#endif
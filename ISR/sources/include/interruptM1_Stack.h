@@ -0,0 +1,52 @@
+/* =============================================================================
+Z80 interrupt Mode 1 ISR Stack MSX SDCC Library (fR3eL Project)
+Stack for the ISR compiled with ISR_OWN_STACK (ISR_Stack), and measure of its
+maximum use.
+https://github.com/mvac7/SDCC_MSX_fR3eL
+============================================================================= */
+
+#ifndef  __INTERRUPT_M1_STACK_H__
+#define  __INTERRUPT_M1_STACK_H__
+
+
+// Size of the stack of the ISR, in bytes. The ISR (20), the hooks and your
+// functions use it. Compile the ISR and this library with the same value.
+#ifndef ISR_STACK_SIZE
+#define ISR_STACK_SIZE	128
+#endif
+
+#define ISR_STACK_FILL	0xA5	// value of the bytes not used
+
+
+// Stack of the ISR. It must be in a page that is never switched (page 3).
+extern char ISR_stack[ISR_STACK_SIZE];
+
+
+
+
+/* =============================================================================
+ Init_ISRStack
+
+ Function : Fill the stack of the ISR with ISR_STACK_FILL, to measure its use.
+            Call it before installing the ISR.
+ Input    : -
+ Output   : -
+============================================================================= */
+void Init_ISRStack(void);
+
+
+
+/* =============================================================================
+ Get_ISRStackPeak
+
+ Function : Returns the maximum number of bytes used in the stack of the ISR
+            since Init_ISRStack (high-water mark)
+ Input    : -
+ Output   : [unsigned int] bytes (ISR_STACK_SIZE = it may have overflowed)
+============================================================================= */
+unsigned int Get_ISRStackPeak(void);
+
+
+
+
+#endif
@@ -0,0 +1,90 @@
+/* =============================================================================
+Z80 interrupt Mode 1 C handlers MSX SDCC Library (fR3eL Project)
+Macros to use C functions as ISR or as hook functions, saving only the
+registers that the code compiled by SDCC can change.
+https://github.com/mvac7/SDCC_MSX_fR3eL
+============================================================================= */
+
+#ifndef  __INTERRUPT_M1_WRAPPER_H__
+#define  __INTERRUPT_M1_WRAPPER_H__
+
+
+// A function compiled by SDCC (sdcccall 1) can change AF, BC, DE, HL and IY.
+// It keeps IX (frame pointer), and the generated code does not use the
+// alternate registers (check it with CHECK_ALTREGS).
+// If the handlers and the functions that they call are compiled with
+// --reserve-regs-iy, define WRAPPER_SAVE_IY as 0 before the include.
+#ifndef WRAPPER_SAVE_IY
+#define WRAPPER_SAVE_IY	1
+#endif
+
+#if WRAPPER_SAVE_IY
+#define  WRAPPER_PUSH_IY  __asm push IY __endasm;
+#define  WRAPPER_POP_IY   __asm pop  IY __endasm;
+#else
+#define  WRAPPER_PUSH_IY
+#define  WRAPPER_POP_IY
+#endif
+
+
+
+
+/* =============================================================================
+ ISR_C_HANDLER
+
+ Function : Define an ISR that calls a C function. It saves AF, BC, DE, HL
+            (and IY), reads the VDP status register 0 (acknowledges the VDP
+            interrupt) and calls the function with it.
+            The function must test bit 7 of the status (VBLANK) and attend
+            the other devices (KEYI) itself.
+            The registers saved are always the same, even if the function
+            does not use them: 21 T-states for each of BC, DE and HL, and
+            29 for IY (178 T-states in total with a RET in the function).
+ Input    : [name] name of the ISR (for Install_ISR)
+            [func] void func(char status)
+============================================================================= */
+#define ISR_C_HANDLER(name, func) \
+void name(void) __naked \
+{ \
+	WRAPPER_PUSH_IY \
+	__asm push HL __endasm; \
+	__asm push DE __endasm; \
+	__asm push BC __endasm; \
+	__asm push AF __endasm; \
+	__asm in   A,(0x99) __endasm; \
+	__asm call _##func __endasm; \
+	__asm pop  AF __endasm; \
+	__asm pop  BC __endasm; \
+	__asm pop  DE __endasm; \
+	__asm pop  HL __endasm; \
+	WRAPPER_POP_IY \
+	__asm ei __endasm; \
+	__asm ret __endasm; \
+}
+
+
+
+/* =============================================================================
+ HOOK_C_HANDLER
+
+ Function : Define a hook function that calls a C function and keeps AF
+            (as PUSH_AF and POP_AF). The ISRs that call the hooks (BIOS,
+            ISR_Basic and its variants) already save the other registers.
+            With an ISR that does not save IY (ISR_Shadow), compile the
+            function with --reserve-regs-iy.
+ Input    : [name] name of the hook function (for Install_TIMI, Add_Handler...)
+            [func] void func(void)
+============================================================================= */
+#define HOOK_C_HANDLER(name, func) \
+void name(void) __naked \
+{ \
+	__asm push AF __endasm; \
+	__asm call _##func __endasm; \
+	__asm pop  AF __endasm; \
+	__asm ret __endasm; \
+}
+
+
+
+
+#endif
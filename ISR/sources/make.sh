@@ -0,0 +1,42 @@
+#!/bin/sh
+# Build of the objects on Linux/macOS (same as MAKEFILE.BAT)
+set -e
+cd "$(dirname "$0")"
+# get SDCC version
+sdcc -v
+mkdir -p build
+mkdir -p ../_release
+echo Compiling Object
+sdcc -mz80 -c -o build/ src/interruptM1_ISR.c
+echo Compiling ISR variants
+VARIANT=src/interruptM1_ISRvariant.c
+sdcc -mz80 -c -DISR_NAME=ISR_Basic_NoAlt -DISR_SAVE_ALTREGS=0 -o build/ISR_Basic_NoAlt.rel $VARIANT
+sdcc -mz80 -c -DISR_NAME=ISR_TIMI -DISR_CALL_KEYI=0 -o build/ISR_TIMI.rel $VARIANT
+sdcc -mz80 -c -DISR_NAME=ISR_TIMI_NoAlt -DISR_CALL_KEYI=0 -DISR_SAVE_ALTREGS=0 -o build/ISR_TIMI_NoAlt.rel $VARIANT
+sdcc -mz80 -c -DISR_NAME=ISR_KEYI -DISR_CALL_TIMI=0 -o build/ISR_KEYI.rel $VARIANT
+sdcc -mz80 -c -DISR_NAME=ISR_NoHooks -DISR_CALL_KEYI=0 -DISR_CALL_TIMI=0 -o build/ISR_NoHooks.rel $VARIANT
+sdcc -mz80 -c -DISR_NAME=ISR_Line -DISR_LINE_INT=1 -o build/ISR_Line.rel $VARIANT
+sdcc -mz80 -c -DISR_NAME=ISR_MegaROM -DISR_MEGAROM=1 -o build/ISR_MegaROM.rel $VARIANT
+sdcc -mz80 -c -DISR_NAME=ISR_MegaROM_SCC -DISR_MEGAROM=1 -DMEGAROM_KONAMI_SCC -o build/ISR_MegaROM_SCC.rel $VARIANT
+sdcc -mz80 -c -DISR_NAME=ISR_DOS2 -DISR_DOS2_MAPPER=1 -o build/ISR_DOS2.rel $VARIANT
+sdcc -mz80 -c -DISR_NAME=ISR_Stack -DISR_OWN_STACK=1 -o build/ISR_Stack.rel $VARIANT
+sdcc -mz80 -c -DISR_NAME=ISR_Shadow -DISR_SHADOW_REGS=1 -DISR_SAVE_INDEXREGS=0 -o build/ISR_Shadow.rel $VARIANT
+sdcc -mz80 -c -DISR_NAME=ISR_Nested -DISR_NESTED=1 -o build/ISR_Nested.rel $VARIANT
+sdcc -mz80 -c -o build/ src/interruptM1_ISRauto.c
+echo Compiling relocatable ISR
+sdcc -mz80 -c -o build/ src/interruptM1_ISRreloc.c
+echo Compiling Dispatcher
+sdcc -mz80 -c -o build/ src/interruptM1_Dispatch.c
+echo Compiling Deferred work queue
+sdcc -mz80 -c -o build/ src/interruptM1_Deferred.c
+echo Compiling Line interrupt
+sdcc -mz80 -c -o build/ src/interruptM1_LineInt.c
+echo Compiling Page 0 RAM
+sdcc -mz80 -c -o build/ src/interruptM1_Page0.c
+echo Compiling MegaROM banks
+sdcc -mz80 -c -o build/ src/interruptM1_MegaROM.c
+sdcc -mz80 -c -DMEGAROM_KONAMI_SCC -o build/interruptM1_MegaROM_SCC.rel src/interruptM1_MegaROM.c
+echo Compiling ISR stack
+sdcc -mz80 -c -o build/ src/interruptM1_Stack.c
+echo Copying objects and headers to _release
+cp build/*.rel include/*.h ../_release/
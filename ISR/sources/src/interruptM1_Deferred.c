@@ -0,0 +1,135 @@
+/* =============================================================================
+Z80 interrupt Mode 1 Deferred work MSX SDCC Library (fR3eL Project)
+Version: 1.0 (17/10/2026)
+Author: mvac7/303bcn
+Architecture: MSX
+Format: C Object (SDCC .rel)
+Programming language: C and Z80 assembler
+Compiler: SDCC 4.4 or newer
+
+fR3eL Project
+https://github.com/mvac7/SDCC_MSX_fR3eL
+
+Description:
+Queue of work posted by the interrupt handlers (top half) and executed by the
+main loop with interrupts enabled (bottom half).
+
+It is a ring buffer with a single producer (the interrupt) and a single
+consumer (the main loop). Each index is a byte written only by its owner, so
+there is no need to disable the interrupts.
+
+History of versions:
+- v1.0 (17/10/2026) First version
+============================================================================= */
+
+#include "../include/interruptM1_Deferred.h"
+
+
+#define DEFER_MASK	(DEFER_SIZE-1)
+
+
+DEFER_ITEM DEFER_queue[DEFER_SIZE];
+char DEFER_head;	//next free item. Written by the interrupt.
+char DEFER_tail;	//next item to execute. Written by the main loop.
+
+char DEFER_overflow;
+
+
+
+
+/* =============================================================================
+ Init_Deferred
+
+ Function : Empty the queue
+ Input    : -
+ Output   : -
+============================================================================= */
+void Init_Deferred(void)
+{
+	DEFER_head = 0;
+	DEFER_tail = 0;
+	DEFER_overflow = 0;
+}
+
+
+
+/* =============================================================================
+ Post_Deferred
+
+ Function : Add a work item to the queue. 
+            Only call it from the interrupt (TIMI/KEYI functions or ISR).
+ Input    : [func] Function address
+            [arg] value for the function
+ Output   : 1 = posted; 0 = the queue is full
+============================================================================= */
+char Post_Deferred(DEFER_FUNC func, unsigned int arg) __naked
+{
+func;	//HL
+arg;	//DE
+__asm
+  push DE               ;arg
+  ex   DE,HL            ;DE = func
+
+  ld   A,(#_DEFER_head)
+  ld   L,A
+  inc  A
+  and  #DEFER_MASK
+  ld   C,A              ;new head
+  ld   A,(#_DEFER_tail)
+  cp   C
+  jr   Z,Post_full      ;IF new head == tail THEN queue full
+
+  ld   H,#0             ;HL = head * 4
+  add  HL,HL
+  add  HL,HL
+  ld   A,C
+  ld   BC,#_DEFER_queue
+  add  HL,BC
+
+  ld   (HL),E           ;func
+  inc  HL
+  ld   (HL),D
+  inc  HL
+  pop  DE               ;arg
+  ld   (HL),E
+  inc  HL
+  ld   (HL),D
+
+  ld   (#_DEFER_head),A ;publish the item
+  ld   A,#1
+  ret
+
+Post_full:
+  pop  DE
+  ld   HL,#_DEFER_overflow
+  inc  (HL)
+  jr   NZ,Post_exit
+  dec  (HL)             ;stop at 255
+Post_exit:
+  xor  A
+  ret
+__endasm;
+}
+
+
+
+/* =============================================================================
+ RunDeferred
+
+ Function : Execute the work items of the queue, with interrupts enabled.
+            Call it from the main loop (after HALT).
+ Input    : -
+ Output   : -
+============================================================================= */
+void RunDeferred(void)
+{
+	DEFER_ITEM* item;
+
+	while (DEFER_tail != DEFER_head)
+	{
+		item = &DEFER_queue[DEFER_tail];
+		item->func(item->arg);
+		// the item is released after its execution
+		DEFER_tail = (DEFER_tail + 1) & DEFER_MASK;
+	}
+}
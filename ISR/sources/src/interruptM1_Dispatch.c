@@ -0,0 +1,931 @@
+/* =============================================================================
+Z80 interrupt Mode 1 VBLANK Dispatcher MSX SDCC Library (fR3eL Project)
+Version: 1.10 (17/10/2026)
+Author: mvac7/303bcn
+Architecture: MSX
+Format: C Object (SDCC .rel)
+Programming language: C and Z80 assembler
+Compiler: SDCC 4.4 or newer
+
+fR3eL Project
+https://github.com/mvac7/SDCC_MSX_fR3eL
+
+Description:
+Table of VBLANK handlers with priorities, executed from the TIMI hook
+(ISR_Basic, its variants or the BIOS ISR).
+
+The table is not walked in the interrupt. Every time it changes, a sequence
+of direct CALLs is generated in RAM and the TIMI hook jumps to it:
+
+  push AF                      ;the BIOS saves A in STATFL after the hook
+  ld   HL,(_DISPATCH_frames)   ;frames counter
+  inc  HL
+  ld   (_DISPATCH_frames),HL
+  call handler1
+  call handler2
+  ...
+  call handlerN
+  pop  AF
+  ret
+
+A handler with a divider N is only executed one of each N frames:
+
+  ld   HL,#counter
+  dec  (HL)
+  jr   NZ,next
+  ld   (HL),#N
+  call handler
+next:
+
+The counters are set again when the frames counter wraps, because 65536 is
+not a multiple of most dividers. This is only generated with dividers:
+
+  ld   A,H
+  or   L
+  jr   NZ,+11
+  ld   HL,#_DISPATCH_wrap      ;counters at the frame 0
+  ld   DE,#_DISPATCH_counter
+  ld   BC,#DISPATCH_MAX
+  ldir
+
+A handler with a segment of the memory mapper (MSX-DOS2) selects it before
+and selects again the segment of the program after it:
+
+  in   A,(0xFE)
+  push AF
+  ld   A,#segment
+  out  (0xFE),A
+  call handler
+  pop  AF
+  out  (0xFE),A
+
+Installed with Install_DispatcherISR, the whole ISR is generated, with only
+the work selected (no hooks by default), and the vector 0x0038 jumps to it:
+
+  push IY / push HL / push DE / push BC / push AF  ;(+ IX and alternate registers)
+  (call 0xFD9A)                          ;KEYI hook
+  in   A,(0x99)
+  and  A
+  jp   P,exit
+  ld   (0xF3E7),A                        ;STATFL
+  (frames counter and CALLs to the handlers)
+exit:
+  pop  AF / pop BC / pop DE / pop HL
+  ei
+  ret
+
+With a frame budget (Set_FrameBudget), the handlers with a declared cost
+(Set_HandlerCost) are only executed while the cost fits in the T-states left
+in the frame:
+
+  ld   HL,#budget of the handler
+  call Dispatch_Budget
+  jr   Z,next
+  call handler
+next:
+
+A handler that does not fit is deferred to the next frame, where it is
+executed even if there is no budget left, so it is never dropped.
+With a divider, the counter is reloaded on its frame even if the handler is
+deferred or paused, so the phase is kept. A handler deferred in the last
+frame is checked again although it is not its frame:
+
+  ld   A,(deferred)  ;1 = deferred in the last frame
+  ld   HL,#counter
+  dec  (HL)
+  jr   NZ,1$
+  ld   (HL),#N
+  inc  A             ;its frame
+1$:
+  or   A
+  jr   Z,next
+  cp   #e            ;(jr next if paused)
+  ld   HL,#budget of the handler
+  call Dispatch_Budget
+  jr   Z,next
+  call handler
+next:
+
+A paused handler keeps its place in the sequence: the opcode of its CALL is
+changed to LD HL,nn, that skips the address of the function. A handler with
+cost is paused in the CP n before the check of the budget, that is changed
+to JR e, so it does not use the budget nor it is deferred. It is one byte,
+so the change does not need to generate the code again nor to disable the
+interrupts.
+The changes of the table that a handler can see (the entries moved by
+Add_Handler and Remove_Handler, the address of the CALL of each entry and
+the change of sequence) are done in a critical section, so a handler can
+pause or resume other handler. The opcodes of the new sequence are set again
+from the entries in the same section: a pause done while the sequence is
+generated is not lost.
+
+Two code buffers are used, so that the sequence being executed is never
+modified. The change from one to another is done in the hook address (or in
+the vector of the ISR). They are given by the program (Init_Dispatcher), in
+page 3: the code is executed from the hook or from 0x0038.
+
+History of versions:
+- v1.10 (17/10/2026) The table is changed in a critical section (Pause_Handler from a handler)
+- v1.9 (17/10/2026) The code buffers are given by the program (page 3)
+- v1.8 (17/10/2026) The counter of a divider is not delayed by a deferral or a pause
+- v1.7 (17/10/2026) The phase of the dividers is kept when the frames wrap
+- v1.6 (17/10/2026) Init_Dispatcher generates the frames counter (empty table)
+- v1.5 (17/10/2026) Keeps AF in the TIMI hook (the last handler is a CALL)
+- v1.4 (17/10/2026) Frame budget with deferral of the handlers that do not fit
+- v1.3 (17/10/2026) Pause and resume of the handlers (only the opcode is changed)
+- v1.2 (17/10/2026) Generation of the complete ISR (Install_DispatcherISR)
+- v1.1 (17/10/2026) Segment of the memory mapper for each handler
+- v1.0 (17/10/2026) First version
+============================================================================= */
+
+#include "../include/interruptM1_ISR.h"
+#include "../include/interruptM1_Dispatch.h"
+
+
+#define HINT     0x0038 //Z80 INT (RST $38) - M1 Interrupt vector
+#define HKEYI	 0xFD9A //Hook KEYI. Interrupt handler device other than the VDP
+#define HTIMI	 0xFD9F //Hook TIMI. Interrupt handler VDP VBLANK
+
+#define STATFL	 0xF3E7 //VDP status register 0 (system variable)
+
+#define JP_CODE		0xC3
+#define CALL_CODE	0xCD
+#define RET_CODE	0xC9
+
+#define LDHL_CODE	0x21
+#define LDHLNN_CODE	0x2A
+#define LDNNHL_CODE	0x22
+#define INCHL_CODE	0x23
+#define DECiHL_CODE	0x35
+#define JRNZ_CODE	0x20
+#define LDiHL_CODE	0x36
+#define LDAN_CODE	0x3E
+#define OUTNA_CODE	0xD3
+#define JRZ_CODE	0x28
+#define JR_CODE		0x18
+#define CPN_CODE	0xFE
+#define LDANN_CODE	0x3A
+#define INCA_CODE	0x3C
+#define ORA_CODE	0xB7
+#define LDAH_CODE	0x7C
+#define ORL_CODE	0xB5
+#define LDDE_CODE	0x11
+#define LDBC_CODE	0x01
+#define ED_PREFIX	0xED
+#define LDIR_CODE	0xB0
+
+#define PUSHHL_CODE	0xE5
+#define PUSHDE_CODE	0xD5
+#define PUSHBC_CODE	0xC5
+#define PUSHAF_CODE	0xF5
+#define POPHL_CODE	0xE1
+#define POPDE_CODE	0xD1
+#define POPBC_CODE	0xC1
+#define POPAF_CODE	0xF1
+#define IX_PREFIX	0xDD
+#define IY_PREFIX	0xFD
+#define EXX_CODE	0xD9
+#define EXAF_CODE	0x08
+#define INAN_CODE	0xDB
+#define ANDA_CODE	0xA7
+#define JPP_CODE	0xF2
+#define LDNNA_CODE	0x32
+#define EI_CODE		0xFB
+
+// Maximum size of each part of the generated code
+#define DISPATCH_REGS_SIZE		14	//push IY, IX (4), main (4) and alternate registers (6); push AF in the hook
+#define DISPATCH_KEYI_SIZE		3	//call HKEYI
+#define DISPATCH_VDP_SIZE		9	//in A,(0x99) / and A / jp P,exit / ld (STATFL),A
+#define DISPATCH_FRAMES_SIZE	22	//ld HL,(nn) / inc HL / ld (nn),HL (+ ld A,H / or L / jr NZ,e / ld HL,nn / ld DE,nn / ld BC,nn / ldir)
+#define DISPATCH_RELOAD_SIZE	6	//ld HL,(nn) / ld (nn),HL (frame budget)
+#define DISPATCH_DIVIDER_SIZE	15	//ld HL,nn / dec (HL) / jr NZ,e / ld (HL),n (+ ld A,(nn) / inc A / or A / jr Z,e with cost)
+#define DISPATCH_BUDGET_SIZE	10	//cp n / ld HL,nn / call Dispatch_Budget / jr Z,e
+#define DISPATCH_SEGMENT_SIZE	10	//in A,(n) / push AF / ld A,n / out (n),A + pop AF / out (n),A
+#define DISPATCH_CALL_SIZE		3	//call nn (ld HL,nn)
+#define DISPATCH_EXIT_SIZE		(DISPATCH_REGS_SIZE+2)	//pop of the registers / ei / ret (pop AF / ret)
+
+#define DISPATCH_HANDLER_SIZE	(DISPATCH_DIVIDER_SIZE+DISPATCH_BUDGET_SIZE+DISPATCH_SEGMENT_SIZE+DISPATCH_CALL_SIZE)
+
+// DISPATCH_CODE_SIZE (header) is the size of the buffer with all the parts
+#if DISPATCH_CODE_SIZE != (DISPATCH_REGS_SIZE+DISPATCH_KEYI_SIZE+DISPATCH_VDP_SIZE+DISPATCH_FRAMES_SIZE+DISPATCH_RELOAD_SIZE+DISPATCH_MAX*DISPATCH_HANDLER_SIZE+DISPATCH_EXIT_SIZE)
+#error "DISPATCH_CODE_SIZE does not match the parts of the generated code"
+#endif
+
+
+DISPATCH_ENTRY DISPATCH_table[DISPATCH_MAX];
+char DISPATCH_count;
+
+// Countdown of the handlers with divider. They are indexed by the slot of the
+// handler, which does not change when the table is reordered.
+char DISPATCH_counter[DISPATCH_MAX];
+
+// Counters at the frame 0, copied when DISPATCH_frames wraps
+char DISPATCH_wrap[DISPATCH_MAX];
+
+unsigned int DISPATCH_frames;
+
+// Cost and deferral of the handlers. Indexed by the slot, as the counters.
+DISPATCH_BUDGET DISPATCH_budgets[DISPATCH_MAX];
+
+unsigned int DISPATCH_budget;	//T-states of each frame (0 = no budget)
+unsigned int DISPATCH_left;		//T-states left in the frame
+unsigned int DISPATCH_deferred;
+
+char* DISPATCH_code;	//two buffers of DISPATCH_CODE_SIZE (given by the program)
+char* DISPATCH_active;	//code executed from the hook (or from 0x0038)
+
+char DISPATCH_isr;		//0 = TIMI hook; else, options of the ISR + 0x80
+
+
+void Build_Dispatcher(void);
+char* Build_SaveRegs(char* code);
+char* Build_RestoreRegs(char* code);
+void Copy_Handler(DISPATCH_ENTRY* dest, DISPATCH_ENTRY* source);
+void Patch_Handler(DISPATCH_ENTRY* entry);
+void Dispatch_Budget(void);
+DISPATCH_ENTRY* Find_Handler(void (*func)(void));
+
+
+
+
+/* =============================================================================
+ Init_Dispatcher
+
+ Function : Initialize the table of handlers (empty). The generated code
+            only counts the frames.
+ Input    : [code] address of a buffer of 2*DISPATCH_CODE_SIZE bytes in page 3
+            for the generated code
+ Output   : -
+============================================================================= */
+void Init_Dispatcher(char* code)
+{
+	DISPATCH_code = code;
+	DISPATCH_count = 0;
+	DISPATCH_frames = 0;
+	DISPATCH_isr = 0;
+	DISPATCH_budget = 0;
+	DISPATCH_deferred = 0;
+	DISPATCH_active = code + DISPATCH_CODE_SIZE;
+	Build_Dispatcher();		//frames counter only
+}
+
+
+
+/* =============================================================================
+ Install_Dispatcher
+
+ Function : Set the dispatcher in the TIMI hook, with Install_TIMI of the
+            interruptM1_Hooks library (interruptM1_HooksAuto also updates the
+            ISR installed with Install_ISR_Auto)
+ Input    : -
+ Output   : -
+============================================================================= */
+void Install_Dispatcher(void) __naked
+{
+__asm
+  ld   HL,(#_DISPATCH_active)
+  jp   _Install_TIMI
+__endasm;
+}
+
+
+
+/* =============================================================================
+ Install_DispatcherISR
+
+ Function : Generate an ISR with the handlers and set it in the ISR vector
+            (0x0038). The hooks are not called, unless it is selected.
+ Input    : [options] DISPATCH_ISR_KEYI, DISPATCH_ISR_ALTREGS and/or
+            DISPATCH_ISR_INDEXREGS (0 = only the main registers and IY
+            are saved)
+ Output   : -
+============================================================================= */
+void Install_DispatcherISR(char options)
+{
+	DISPATCH_isr = options | DISPATCH_ISR_MODE;
+	Build_Dispatcher();
+
+	EnterCritical();
+	*(char*)HINT = JP_CODE;
+	*(char**)(HINT+1) = DISPATCH_active;
+	ExitCritical();
+}
+
+
+
+/* =============================================================================
+ Add_Handler
+
+ Function : Add a function to the table of handlers.
+            Handlers with the same priority are executed in order of addition.
+ Input    : [func] Function address
+            [priority] higher values are executed first
+ Output   : 1 = added; 0 = the table is full
+============================================================================= */
+char Add_Handler(void (*func)(void), char priority)
+{
+	DISPATCH_ENTRY* entry;
+	char i;
+	char slot;
+
+	if (DISPATCH_count >= DISPATCH_MAX) return 0;
+
+	// first slot not used by other handler
+	for (slot=0;;slot++)
+	{
+		entry = DISPATCH_table;
+		for (i=DISPATCH_count;i>0;i--)
+		{
+			if (entry->slot == slot) break;
+			entry++;
+		}
+		if (i==0) break;
+	}
+
+	// insert after the handlers with the same or higher priority
+	EnterCritical();
+	i = DISPATCH_count;
+	entry = &DISPATCH_table[i];
+	while (i>0 && entry[-1].priority < priority)
+	{
+		Copy_Handler(entry, entry-1);
+		entry--;
+		i--;
+	}
+
+	entry->func = func;
+	entry->priority = priority;
+	entry->slot = slot;
+	entry->divider = 1;
+	entry->phase = 0;
+	entry->segment = DISPATCH_NOSEGMENT;
+	entry->paused = 0;
+	entry->call = 0;
+	DISPATCH_budgets[slot].cost = 0;
+	DISPATCH_budgets[slot].deferred = 0;
+	DISPATCH_count++;
+	ExitCritical();
+
+	Build_Dispatcher();
+	return 1;
+}
+
+
+
+/* =============================================================================
+ Remove_Handler
+
+ Function : Remove a function from the table of handlers
+ Input    : [func] Function address
+ Output   : 1 = removed; 0 = not found
+============================================================================= */
+char Remove_Handler(void (*func)(void))
+{
+	DISPATCH_ENTRY* entry = DISPATCH_table;
+	char i;
+
+	for (i=0;i<DISPATCH_count;i++)
+	{
+		if (entry->func == func)
+		{
+			EnterCritical();
+			DISPATCH_count--;
+			for (;i<DISPATCH_count;i++)
+			{
+				Copy_Handler(entry, entry+1);
+				entry++;
+			}
+			ExitCritical();
+			Build_Dispatcher();
+			return 1;
+		}
+		entry++;
+	}
+	return 0;
+}
+
+
+
+/* =============================================================================
+ Set_HandlerDivider
+
+ Function : Execute a handler only on the frames where
+            (frame + phase) % divider == 0
+            Use different phases to spread the handlers on different frames.
+ Input    : [func] Function address
+            [divider] 1 = every frame
+            [phase] offset in frames
+ Output   : 1 = done; 0 = not found
+============================================================================= */
+char Set_HandlerDivider(void (*func)(void), char divider, char phase)
+{
+	DISPATCH_ENTRY* entry = DISPATCH_table;
+	char i;
+
+	if (divider==0) divider = 1;
+
+	for (i=DISPATCH_count;i>0;i--)
+	{
+		if (entry->func == func)
+		{
+			entry->divider = divider;
+			entry->phase = phase;
+
+			// next frame executed: (DISPATCH_frames + counter)
+			EnterCritical();
+			DISPATCH_counter[entry->slot] = divider - ((DISPATCH_frames + phase) % divider);
+			DISPATCH_wrap[entry->slot] = divider - ((phase + divider - 1) % divider);
+			ExitCritical();
+
+			Build_Dispatcher();
+			return 1;
+		}
+		entry++;
+	}
+	return 0;
+}
+
+
+
+/* =============================================================================
+ Set_HandlerSegment
+
+ Function : Select a segment of the memory mapper (MSX-DOS2) before executing
+            a handler
+ Input    : [func] Function address
+            [segment] segment number or DISPATCH_NOSEGMENT
+ Output   : 1 = done; 0 = not found
+============================================================================= */
+char Set_HandlerSegment(void (*func)(void), char segment)
+{
+	DISPATCH_ENTRY* entry = DISPATCH_table;
+	char i;
+
+	for (i=DISPATCH_count;i>0;i--)
+	{
+		if (entry->func == func)
+		{
+			entry->segment = segment;
+			Build_Dispatcher();
+			return 1;
+		}
+		entry++;
+	}
+	return 0;
+}
+
+
+
+/* =============================================================================
+ Set_FrameBudget
+
+ Function : Set the T-states of each frame for the handlers with a cost
+ Input    : [tstates] 0 = no budget (all the handlers are executed)
+ Output   : -
+============================================================================= */
+void Set_FrameBudget(unsigned int tstates)
+{
+	DISPATCH_budget = tstates;
+	Build_Dispatcher();
+}
+
+
+
+/* =============================================================================
+ Set_HandlerCost
+
+ Function : Declare the cost of a handler in T-states, to execute it only
+            while it fits in the frame budget
+ Input    : [func] Function address
+            [cost] T-states (0 = always executed, out of the budget)
+ Output   : 1 = done; 0 = not found
+============================================================================= */
+char Set_HandlerCost(void (*func)(void), unsigned int cost)
+{
+	DISPATCH_ENTRY* entry = Find_Handler(func);
+	DISPATCH_BUDGET* budget;
+
+	if (entry==0) return 0;
+	budget = &DISPATCH_budgets[entry->slot];
+
+	EnterCritical();
+	budget->cost = cost;
+	budget->deferred = 0;
+	ExitCritical();
+
+	Build_Dispatcher();
+	return 1;
+}
+
+
+
+/* =============================================================================
+ Pause_Handler
+
+ Function : Pause a handler without removing it from the table.
+            The CALL is changed to a LD HL,nn (one byte), or the CP n before
+            the check of the budget to a JR e.
+ Input    : [func] Function address
+ Output   : 1 = done; 0 = not found
+============================================================================= */
+char Pause_Handler(void (*func)(void))
+{
+	DISPATCH_ENTRY* entry = Find_Handler(func);
+
+	if (entry==0) return 0;
+	entry->paused = 1;
+	if (entry->call) Patch_Handler(entry);	//else not generated: paused in the next generation
+	return 1;
+}
+
+
+
+/* =============================================================================
+ Resume_Handler
+
+ Function : Resume a handler paused with Pause_Handler
+ Input    : [func] Function address
+ Output   : 1 = done; 0 = not found
+============================================================================= */
+char Resume_Handler(void (*func)(void))
+{
+	DISPATCH_ENTRY* entry = Find_Handler(func);
+
+	if (entry==0) return 0;
+	entry->paused = 0;
+	if (entry->call) Patch_Handler(entry);
+	return 1;
+}
+
+
+
+/* -----------------------------------------------------------------------------
+ Find_Handler
+ Output: entry of the function or 0
+----------------------------------------------------------------------------- */
+DISPATCH_ENTRY* Find_Handler(void (*func)(void))
+{
+	DISPATCH_ENTRY* entry = DISPATCH_table;
+	char i;
+
+	for (i=DISPATCH_count;i>0;i--)
+	{
+		if (entry->func == func) return entry;
+		entry++;
+	}
+	return 0;
+}
+
+
+
+/* -----------------------------------------------------------------------------
+ Dispatch_Budget
+ Called from the generated code, before a handler with cost.
+ Input: HL = DISPATCH_BUDGET of the handler
+ Output: NZ = execute the handler; Z = deferred to the next frame
+ Changes AF, DE and HL.
+----------------------------------------------------------------------------- */
+void Dispatch_Budget(void) __naked
+{
+__asm
+  ld   E,(HL)
+  inc  HL
+  ld   D,(HL)        ;DE = cost
+  inc  HL
+  push HL            ;deferred flag
+  ld   HL,(#_DISPATCH_left)
+  or   A
+  sbc  HL,DE
+  jr   NC,1$         ;IF it fits THEN execute
+
+  ex   (SP),HL
+  ld   A,(HL)
+  or   A
+  jr   NZ,2$         ;IF it was deferred in the last frame THEN execute
+
+  ld   (HL),#1       ;defer to the next frame
+  pop  HL
+  ld   HL,(#_DISPATCH_deferred)
+  inc  HL
+  ld   (#_DISPATCH_deferred),HL
+  xor  A             ;Z
+  ret
+
+2$:
+  ld   (HL),#0
+  pop  HL
+  ld   HL,#0         ;no budget left
+  ld   (#_DISPATCH_left),HL
+  ret                ;NZ
+
+1$:
+  ld   (#_DISPATCH_left),HL
+  pop  HL
+  ld   (HL),#0
+  or   #1            ;NZ
+  ret
+__endasm;
+}
+
+
+
+/* -----------------------------------------------------------------------------
+ Copy_Handler
+----------------------------------------------------------------------------- */
+void Copy_Handler(DISPATCH_ENTRY* dest, DISPATCH_ENTRY* source)
+{
+	dest->func = source->func;
+	dest->priority = source->priority;
+	dest->slot = source->slot;
+	dest->divider = source->divider;
+	dest->phase = source->phase;
+	dest->segment = source->segment;
+	dest->paused = source->paused;
+	dest->call = source->call;
+}
+
+
+
+/* -----------------------------------------------------------------------------
+ Patch_Handler
+ Sets the opcode of the CALL of the entry (or of the CP n before the check of
+ the budget) from its pause state. One byte: atomic for the interrupt.
+----------------------------------------------------------------------------- */
+void Patch_Handler(DISPATCH_ENTRY* entry)
+{
+	char* call = entry->call;
+
+	if (*call == CPN_CODE || *call == JR_CODE)
+	{
+		if (entry->paused) *call = JR_CODE;
+		else *call = CPN_CODE;
+	}
+	else if (entry->paused) *call = LDHL_CODE;
+	else *call = CALL_CODE;
+}
+
+
+
+/* -----------------------------------------------------------------------------
+ Build_SaveRegs / Build_RestoreRegs
+
+ Generate the save and the restore of the registers of the ISR
+----------------------------------------------------------------------------- */
+char* Build_SaveRegs(char* code)
+{
+	*code++ = IY_PREFIX;		//push IY: the C handlers can change it
+	*code++ = PUSHHL_CODE;
+	if (DISPATCH_isr & DISPATCH_ISR_INDEXREGS)
+	{
+		*code++ = IX_PREFIX;
+		*code++ = PUSHHL_CODE;
+	}
+	*code++ = PUSHHL_CODE;
+	*code++ = PUSHDE_CODE;
+	*code++ = PUSHBC_CODE;
+	*code++ = PUSHAF_CODE;
+	if (DISPATCH_isr & DISPATCH_ISR_ALTREGS)
+	{
+		*code++ = EXX_CODE;
+		*code++ = EXAF_CODE;
+		*code++ = PUSHHL_CODE;
+		*code++ = PUSHDE_CODE;
+		*code++ = PUSHBC_CODE;
+		*code++ = PUSHAF_CODE;
+	}
+	return code;
+}
+
+
+char* Build_RestoreRegs(char* code)
+{
+	if (DISPATCH_isr & DISPATCH_ISR_ALTREGS)
+	{
+		*code++ = POPAF_CODE;
+		*code++ = POPBC_CODE;
+		*code++ = POPDE_CODE;
+		*code++ = POPHL_CODE;
+		*code++ = EXAF_CODE;
+		*code++ = EXX_CODE;
+	}
+	*code++ = POPAF_CODE;
+	*code++ = POPBC_CODE;
+	*code++ = POPDE_CODE;
+	*code++ = POPHL_CODE;
+	if (DISPATCH_isr & DISPATCH_ISR_INDEXREGS)
+	{
+		*code++ = IX_PREFIX;
+		*code++ = POPHL_CODE;
+	}
+	*code++ = IY_PREFIX;
+	*code++ = POPHL_CODE;
+	return code;
+}
+
+
+
+/* -----------------------------------------------------------------------------
+ Build_Dispatcher
+
+ Generates the sequence of CALLs in the free buffer and, if the dispatcher is
+ installed in the TIMI hook (or in the ISR vector), changes it to the new
+ sequence.
+ If the code does not fit in the buffer, the running sequence is not changed.
+ The addresses of the CALLs are kept in [calls] while the code is generated
+ and copied to the entries, with the opcodes set again from the pause state,
+ in the critical section of the change of sequence.
+----------------------------------------------------------------------------- */
+void Build_Dispatcher(void)
+{
+	char* old = DISPATCH_active;
+	char* code;
+	char* start;
+	char* exitjump = 0;
+	DISPATCH_ENTRY* entry = DISPATCH_table;
+	DISPATCH_BUDGET* budget;
+	char* calls[DISPATCH_MAX];
+	char** call = calls;
+	char n = DISPATCH_count;
+	char skip;
+	char divided = 0;
+	unsigned int vector = HTIMI;
+
+	for (skip=n;skip>0;skip--)
+	{
+		if (entry->divider > 1) divided = 1;
+		entry++;
+	}
+	entry = DISPATCH_table;
+
+	if (old == DISPATCH_code) code = DISPATCH_code + DISPATCH_CODE_SIZE;
+	else code = DISPATCH_code;
+	start = code;
+
+	if (DISPATCH_isr)
+	{
+		vector = HINT;
+		code = Build_SaveRegs(code);
+		if (DISPATCH_isr & DISPATCH_ISR_KEYI)
+		{
+			*code++ = CALL_CODE;
+			*(unsigned int*)code = HKEYI;
+			code += 2;
+		}
+		*code++ = INAN_CODE;		//in A,(0x99)
+		*code++ = 0x99;
+		*code++ = ANDA_CODE;
+		*code++ = JPP_CODE;			//IF Not VDP Interrupt THEN exit
+		exitjump = code;
+		code += 2;
+		*code++ = LDNNA_CODE;		//ld (STATFL),A
+		*(unsigned int*)code = STATFL;
+		code += 2;
+	}
+	else *code++ = PUSHAF_CODE;		//the BIOS saves A in STATFL after the hook
+
+	// frames counter
+	*code++ = LDHLNN_CODE;
+	*(unsigned int*)code = (unsigned int)&DISPATCH_frames;
+	code += 2;
+	*code++ = INCHL_CODE;
+	*code++ = LDNNHL_CODE;
+	*(unsigned int*)code = (unsigned int)&DISPATCH_frames;
+	code += 2;
+	if (divided)
+	{
+		*code++ = LDAH_CODE;		//IF the frames counter wraps THEN counters at the frame 0
+		*code++ = ORL_CODE;
+		*code++ = JRNZ_CODE;
+		*code++ = 11;
+		*code++ = LDHL_CODE;
+		*(unsigned int*)code = (unsigned int)DISPATCH_wrap;
+		code += 2;
+		*code++ = LDDE_CODE;
+		*(unsigned int*)code = (unsigned int)DISPATCH_counter;
+		code += 2;
+		*code++ = LDBC_CODE;
+		*(unsigned int*)code = DISPATCH_MAX;
+		code += 2;
+		*code++ = ED_PREFIX;
+		*code++ = LDIR_CODE;
+	}
+
+	if (DISPATCH_budget)
+	{
+		*code++ = LDHLNN_CODE;	//ld HL,(_DISPATCH_budget)
+		*(unsigned int*)code = (unsigned int)&DISPATCH_budget;
+		code += 2;
+		*code++ = LDNNHL_CODE;	//ld (_DISPATCH_left),HL
+		*(unsigned int*)code = (unsigned int)&DISPATCH_left;
+		code += 2;
+	}
+
+	while (n>0)
+	{
+		if (code + DISPATCH_HANDLER_SIZE + DISPATCH_EXIT_SIZE > start + DISPATCH_CODE_SIZE) return;
+
+		budget = &DISPATCH_budgets[entry->slot];
+		if (!DISPATCH_budget) budget = 0;
+		else if (budget->cost == 0) budget = 0;
+		skip = DISPATCH_CALL_SIZE;
+		if (entry->segment != DISPATCH_NOSEGMENT) skip += DISPATCH_SEGMENT_SIZE;
+
+		if (entry->divider > 1)
+		{
+			if (budget)
+			{
+				*code++ = LDANN_CODE;	//ld A,(deferred): 1 = deferred in the last frame
+				*(char**)code = &budget->deferred;
+				code += 2;
+			}
+			*code++ = LDHL_CODE;
+			*(unsigned int*)code = (unsigned int)&DISPATCH_counter[entry->slot];
+			code += 2;
+			*code++ = DECiHL_CODE;
+			*code++ = JRNZ_CODE;
+			if (budget)
+			{
+				*code++ = 3;			//IF not its frame THEN execute only if deferred
+				*code++ = LDiHL_CODE;	//reloaded even if deferred or paused: the phase is kept
+				*code++ = entry->divider;
+				*code++ = INCA_CODE;	//A != 0: its frame
+				*code++ = ORA_CODE;
+				*code++ = JRZ_CODE;		//skip the pause, the budget, the segment and the call
+				*code++ = skip + 10;
+			}
+			else
+			{
+				*code++ = skip + 2;
+				*code++ = LDiHL_CODE;
+				*code++ = entry->divider;
+			}
+		}
+		if (budget)
+		{
+			*call = code;		//paused: skip the budget, the segment and the call
+			if (entry->paused) *code++ = JR_CODE;
+			else *code++ = CPN_CODE;
+			*code++ = skip + 8;
+			*code++ = LDHL_CODE;
+			*(DISPATCH_BUDGET**)code = budget;
+			code += 2;
+			*code++ = CALL_CODE;
+			*(unsigned int*)code = (unsigned int)Dispatch_Budget;
+			code += 2;
+			*code++ = JRZ_CODE;		//IF deferred THEN skip the segment and the call
+			*code++ = skip;
+		}
+		if (entry->segment != DISPATCH_NOSEGMENT)
+		{
+			*code++ = INAN_CODE;		//in A,(n) / push AF: segment of the program
+			*code++ = DISPATCH_SEGMENT_PORT;
+			*code++ = PUSHAF_CODE;
+			*code++ = LDAN_CODE;
+			*code++ = entry->segment;
+			*code++ = OUTNA_CODE;
+			*code++ = DISPATCH_SEGMENT_PORT;
+		}
+		if (budget) *code++ = CALL_CODE;
+		else
+		{
+			*call = code;
+			if (entry->paused) *code++ = LDHL_CODE;		//skip the address
+			else *code++ = CALL_CODE;
+		}
+		*(unsigned int*)code = (unsigned int)entry->func;
+		code += 2;
+		if (entry->segment != DISPATCH_NOSEGMENT)
+		{
+			*code++ = POPAF_CODE;		//select again the segment of the program
+			*code++ = OUTNA_CODE;
+			*code++ = DISPATCH_SEGMENT_PORT;
+		}
+		call++;
+		entry++;
+		n--;
+	}
+
+	if (DISPATCH_isr)
+	{
+		*(char**)exitjump = code;
+		code = Build_RestoreRegs(code);
+		*code++ = EI_CODE;
+	}
+	else *code++ = POPAF_CODE;
+	*code = RET_CODE;
+
+	EnterCritical();
+	entry = DISPATCH_table;
+	call = calls;
+	for (n=DISPATCH_count;n>0;n--)
+	{
+		entry->call = *call++;
+		Patch_Handler(entry);	//paused or resumed by a handler while generating
+		entry++;
+	}
+	DISPATCH_active = start;
+
+	// only the address: a TIMI hook paused (RET) keeps its state
+	if (*(char**)(vector+1) == old) *(char**)(vector+1) = start;
+	ExitCritical();
+}
@@ -1,6 +1,6 @@
 /* =============================================================================
 Z80 interrupt Mode 1 MSX SDCC Library (fR3eL Project)
-Version: 1.2 (31/12/2024)
+Version: 1.3 (17/10/2026)
 Author: mvac7/303bcn
 Architecture: MSX
 Format: C Object (SDCC .rel)
@@ -15,6 +15,8 @@ Library with basic functions to control the Interrupt Service Routine (ISR) for
 Z80 Mode 1 interrupts on MSX system.  
   
 History of versions:
+- v1.3 (17/10/2026) Keeps the state of the interrupts. EnterCritical/ExitCritical
+                    with a nesting counter. ISR variants in their own objects.
 - v1.2 (31/12/2024) Update to SDCC (4.1.12) Z80 calling conventions
 - v1.1 ( 1/09/2021) More functions to control ISR and Hooks (TIMI/KEYI).
 - v1.0 (16/11/2004) First version developed by Avelino Herrera.
@@ -32,6 +34,9 @@ History of versions:
 
 char OLD_ISR[3];
 
+char ISR_critical;		//nesting level of EnterCritical
+char ISR_criticalEI;	//1 = the outer ExitCritical enables the interrupts
+
 
 void ISR_empty(void);
 
@@ -41,21 +46,31 @@ void ISR_empty(void);
 /* =============================================================================
  Save_ISR
 
- Function : Save Old ISR vector
+ Function : Save Old ISR vector and initialize the counter of EnterCritical
  Input    : -
  Output   : -
 ============================================================================= */
 void Save_ISR(void) __naked
 {
 __asm
+  ld   A,I           ;P/V = IFF2 (interrupts enabled)
+  jp   PE,1$
+  ld   A,I           ;NMOS Z80: read again if an interrupt was accepted
+1$:
   di
+  push AF
   
   ; Save old ISR vector
   ld   A,(#HINT)
   ld   (#_OLD_ISR),A
   ld   HL,(#HINT+1)
   ld   (#_OLD_ISR+1),HL
+
+  xor  A             ;no critical section
+  ld   (#_ISR_critical),A
   
+  pop  AF
+  ret  PO           ;IF interrupts were disabled THEN exit
   ei
   ret
 __endasm;
@@ -75,12 +90,18 @@ void Install_ISR(void (*isr)(void)) __naked
 isr;
 __asm
   ; Set new ISR vector
+  ld   A,I           ;P/V = IFF2 (interrupts enabled)
+  jp   PE,1$
+  ld   A,I           ;NMOS Z80: read again if an interrupt was accepted
+1$:
   di
+  push AF
   ld   A,#0xC3       ;add a JP
   ld   (#HINT),A
   ld   (#HINT+1),HL
+  pop  AF
+  ret  PO           ;IF interrupts were disabled THEN exit
   ei
-  
   ret
 __endasm;
 }
@@ -97,7 +118,12 @@ __endasm;
 void Restore_ISR(void) __naked
 {
 __asm
+  ld   A,I           ;P/V = IFF2 (interrupts enabled)
+  jp   PE,1$
+  ld   A,I           ;NMOS Z80: read again if an interrupt was accepted
+1$:
   di
+  push AF
     
   ld   A,(#_OLD_ISR)
   ld   (#HINT),A
@@ -105,8 +131,10 @@ __asm
   ld   HL,(#_OLD_ISR+1)
   ld   (#HINT+1),HL
   
+  pop  AF
+  ret  PO           ;IF interrupts were disabled THEN exit
   ei
-  ret  
+  ret
 __endasm;
 }
 
@@ -126,6 +154,72 @@ void Disable_ISR(void)
 
 
 
+/* =============================================================================
+ EnterCritical
+
+ Function : Disable interrupts and enter a critical section.
+            The critical sections can be nested (ISR_critical counts them):
+            only the ExitCritical of the outer one enables the interrupts
+            again, and only if they were enabled when it was entered.
+ Input    : -
+ Output   : -
+============================================================================= */
+void EnterCritical(void) __naked
+{
+__asm
+  ld   A,I           ;P/V = IFF2 (interrupts enabled)
+  jp   PE,1$
+  ld   A,I           ;NMOS Z80: read again if an interrupt was accepted
+1$:
+  di
+  ld   HL,#_ISR_critical
+  jp   PO,2$
+  ld   (HL),#1       ;interrupts enabled: outer section
+  ld   A,#1
+  ld   (#_ISR_criticalEI),A
+  ret
+
+2$:
+  ld   A,(HL)
+  inc  (HL)
+  or   A
+  ret  NZ            ;IF nested THEN exit
+  ld   (#_ISR_criticalEI),A	;outer section with the interrupts disabled
+  ret
+__endasm;
+}
+
+
+
+/* =============================================================================
+ ExitCritical
+
+ Function : Exit a critical section entered with EnterCritical.
+            The outer one enables the interrupts if they were enabled.
+ Input    : -
+ Output   : 1 = done; 0 = not in a critical section (nothing is done)
+============================================================================= */
+char ExitCritical(void) __naked
+{
+__asm
+  ld   HL,#_ISR_critical
+  ld   A,(HL)
+  or   A
+  ret  Z             ;IF not in a critical section THEN exit (0)
+  dec  (HL)
+  ld   A,#1
+  ret  NZ            ;IF nested THEN exit
+  ld   A,(#_ISR_criticalEI)
+  or   A
+  ld   A,#1
+  ret  Z             ;IF interrupts were disabled THEN exit
+  ei
+  ret
+__endasm;
+}
+
+
+
 /* =============================================================================
 ## Basic ISR for M1 interrupt of Z80
 
@@ -133,8 +227,8 @@ void Disable_ISR(void)
 * Calls the two hooks of the system: TIMI (VBLANK) and KEYI
 
 Note: 
-  You can optimize it, commenting on those records that you know you don't use 
-  (such as alternate records) or removing the KEYI hook. 
+  If you do not need all this work, use one of the variants generated with the
+  interruptM1_ISRvariant.c template (see MAKEFILE.BAT).
 ============================================================================= */
 void ISR_Basic(void) __naked
 {  
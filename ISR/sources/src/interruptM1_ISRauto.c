@@ -0,0 +1,93 @@
+/* =============================================================================
+Z80 interrupt Mode 1 MSX SDCC Library (fR3eL Project)
+Automatic ISR selection
+Version: 1.3 (17/10/2026)
+Author: mvac7/303bcn
+Architecture: MSX
+Format: C Object (SDCC .rel)
+Programming language: C and Z80 assembler
+Compiler: SDCC 4.4 or newer
+
+fR3eL Project
+https://github.com/mvac7/SDCC_MSX_fR3eL
+
+Description:
+Installs the cheapest ISR variant that keeps the behavior of ISR_Basic,
+according to the contents of the KEYI and TIMI hooks.
+A hook that only contains a RET (0xC9) is not called.
+
+Requires the objects of the ISR_Basic, ISR_TIMI, ISR_KEYI and ISR_NoHooks
+variants.
+To update the ISR every time a hook changes, link the interruptM1_HooksAuto
+object instead of interruptM1_Hooks.
+============================================================================= */
+
+#include "../include/interruptM1_ISR.h"
+
+
+#define HINT     0x0038 //Z80 INT (RST $38)  - M1 Interrupt vector
+
+#define HKEYI	 0xFD9A //Hook KEYI. Interrupt handler device other than the VDP. (RS-232C, MSX-Midi, etc)
+#define HTIMI	 0xFD9F //Hook TIMI. Interrupt handler VDP VBLANK
+
+#define JP_CODE	 0xC3
+#define RET_CODE 0xC9
+
+
+
+/* =============================================================================
+ Select_ISR_Auto
+
+ Function : Returns the cheapest ISR for the current state of the hooks
+ Input    : -
+ Output   : ISR Function address
+============================================================================= */
+ISR_FUNC Select_ISR_Auto(void)
+{
+	if (*(char*)HKEYI == RET_CODE)
+	{
+		if (*(char*)HTIMI == RET_CODE) return ISR_NoHooks;
+		return ISR_TIMI;
+	}
+	if (*(char*)HTIMI == RET_CODE) return ISR_KEYI;
+	return ISR_Basic;
+}
+
+
+
+/* =============================================================================
+ Install_ISR_Auto
+
+ Function : Set the cheapest ISR for the current state of the hooks
+ Input    : -
+ Output   : -
+============================================================================= */
+void Install_ISR_Auto(void)
+{
+	Install_ISR(Select_ISR_Auto());
+}
+
+
+
+/* =============================================================================
+ Update_ISR_Auto
+
+ Function : If one of the automatic ISRs is installed, replaces it with the
+            cheapest for the current state of the hooks.
+            It is called by the hook functions (interruptM1_HooksAuto).
+ Input    : -
+ Output   : -
+============================================================================= */
+void Update_ISR_Auto(void)
+{
+	ISR_FUNC current;
+	ISR_FUNC isr;
+
+	if (*(char*)HINT != JP_CODE) return;
+
+	current = *(ISR_FUNC*)(HINT+1);
+	if (current!=ISR_Basic && current!=ISR_TIMI && current!=ISR_KEYI && current!=ISR_NoHooks) return;
+
+	isr = Select_ISR_Auto();
+	if (isr!=current) Install_ISR(isr);
+}
@@ -0,0 +1,293 @@
+/* =============================================================================
+Z80 interrupt Mode 1 MSX SDCC Library (fR3eL Project)
+Relocatable ISR
+Version: 1.3 (17/10/2026)
+Author: mvac7/303bcn
+Architecture: MSX
+Format: C Object (SDCC .rel)
+Programming language: C and Z80 assembler
+Compiler: SDCC 4.4 or newer
+
+fR3eL Project
+https://github.com/mvac7/SDCC_MSX_fR3eL
+
+Description:
+ISR with the same work as ISR_Basic, but with position-independent code
+(only relative jumps). Install_ISR_Reloc copies it to an address of RAM in
+page 3 (0xC000-0xFFFF) and points the vector 0x0038 to the copy.
+
+Page 3 is never switched, so the ISR is executed even when the page where the
+program is (cartridge, mapper segment) is not visible in the interrupt, and
+without inter-slot calls.
+The functions of the hooks must also be in a visible page.
+
+When the program owns the machine, the CALLs of the copy can call the functions
+directly (Install_TIMI_Direct / Install_KEYI_Direct), without the JP of the
+hook. The hook receives the same JP, so it remains coherent for the code that
+reads it. In this mode the functions of the Hooks library (Pause_TIMI,
+Disable_TIMI, Restore_TIMI...) only change the hook, that the copy no longer
+calls: call Reset_ISR_Direct before them.
+
+History of versions:
+- v1.3 (17/10/2026) The copy is only found by the JP of the vector (ISR_Reloc_dest is not initialized)
+- v1.2 (17/10/2026) The direct functions do nothing if the copy is not installed
+- v1.1 (17/10/2026) Direct call to the hook functions
+- v1.0 (17/10/2026) First version
+============================================================================= */
+
+#include "../include/interruptM1_ISR.h"
+
+
+#define HINT     0x0038 //Z80 INT (RST $38)  - M1 Interrupt vector
+
+#define HKEYI	 0xFD9A //Hook KEYI. Interrupt handler device other than the VDP. (RS-232C, MSX-Midi, etc)
+#define HTIMI	 0xFD9F //Hook TIMI. Interrupt handler VDP VBLANK
+
+#define STATFL	 0xF3E7 //VDP status register 0 (system variable)
+
+
+char* ISR_Reloc_dest;	//address of the copy of the ISR (not initialized before Install_ISR_Reloc)
+
+
+
+
+/* =============================================================================
+ Install_ISR_Reloc
+
+ Function : Copy the relocatable ISR (ISR_RELOC_SIZE bytes) to an address of
+            page 3 and set it in the ISR vector
+ Input    : [dest] address in RAM (0xC000-0xFFFF)
+ Output   : -
+============================================================================= */
+void Install_ISR_Reloc(char* dest) __naked
+{
+dest;	//HL
+__asm
+  ex   DE,HL         ;DE = dest
+
+  ld   A,I           ;P/V = IFF2 (interrupts enabled)
+  jp   PE,1$
+  ld   A,I           ;NMOS Z80: read again if an interrupt was accepted
+1$:
+  di
+  push AF
+
+  ld   (#_ISR_Reloc_dest),DE
+  push DE
+  ld   HL,#_ISR_Reloc
+  ld   BC,#ISR_Reloc_end-_ISR_Reloc
+  ldir               ;copy the ISR (it can replace an old copy)
+  pop  HL
+
+  ld   A,#0xC3       ;add a JP
+  ld   (#HINT),A
+  ld   (#HINT+1),HL
+
+  pop  AF
+  ret  PO           ;IF interrupts were disabled THEN exit
+  ei
+  ret
+__endasm;
+}
+
+
+
+/* =============================================================================
+ Install_TIMI_Direct
+
+ Function : The copy of the ISR calls the function directly, instead of the
+            TIMI hook. A JP to the function is also set in the hook.
+            Requires Install_ISR_Reloc: if its copy is not the installed ISR
+            (after Restore_ISR), nothing is changed.
+ Input    : [func] Function address
+ Output   : [char] 1 = installed; 0 = the ISR of Install_ISR_Reloc is not installed
+============================================================================= */
+char Install_TIMI_Direct(void (*func)(void)) __naked
+{
+func;	//HL
+__asm
+  ld   DE,#ISR_Reloc_timi+1-_ISR_Reloc
+  ld   BC,#HTIMI
+  jp   Install_Direct
+__endasm;
+}
+
+
+
+/* =============================================================================
+ Install_KEYI_Direct
+
+ Function : The copy of the ISR calls the function directly, instead of the
+            KEYI hook. A JP to the function is also set in the hook.
+            Requires Install_ISR_Reloc: if its copy is not the installed ISR
+            (after Restore_ISR), nothing is changed.
+ Input    : [func] Function address
+ Output   : [char] 1 = installed; 0 = the ISR of Install_ISR_Reloc is not installed
+============================================================================= */
+char Install_KEYI_Direct(void (*func)(void)) __naked
+{
+func;	//HL
+__asm
+  ld   DE,#ISR_Reloc_keyi+1-_ISR_Reloc
+  ld   BC,#HKEYI
+  jp   Install_Direct
+
+; HL = func; DE = offset of the CALL operand in the ISR; BC = hook
+Install_Direct:
+  push HL
+  ld   HL,(#_ISR_Reloc_dest)
+  call Reloc_Installed
+  pop  HL
+  ld   A,#0
+  ret  NZ            ;IF the copy of the ISR is not installed THEN exit (0)
+
+  ld   A,I           ;P/V = IFF2 (interrupts enabled)
+  jp   PE,1$
+  ld   A,I           ;NMOS Z80: read again if an interrupt was accepted
+1$:
+  di
+  push AF
+
+  ld   A,#0xC3       ;JP func in the hook
+  ld   (BC),A
+  inc  BC
+  ld   A,L
+  ld   (BC),A
+  inc  BC
+  ld   A,H
+  ld   (BC),A
+
+  ex   DE,HL
+  ld   BC,(#_ISR_Reloc_dest)
+  add  HL,BC
+  ld   (HL),E
+  inc  HL
+  ld   (HL),D        ;CALL func in the copy of the ISR
+
+  pop  AF
+  ld   A,#1
+  ret  PO           ;IF interrupts were disabled THEN exit
+  ei
+  ret
+
+; HL = ISR_Reloc_dest. Output: Z = the vector 0x0038 jumps to the copy
+Reloc_Installed:
+  ld   A,(#HINT)
+  cp   #0xC3
+  ret  NZ
+  ld   A,(#HINT+1)
+  cp   L
+  ret  NZ
+  ld   A,(#HINT+2)
+  cp   H
+  ret
+__endasm;
+}
+
+
+
+/* =============================================================================
+ Reset_ISR_Direct
+
+ Function : The copy of the ISR calls again the TIMI and KEYI hooks.
+            The hooks are not changed.
+            If the copy is not the installed ISR, nothing is changed.
+ Input    : -
+ Output   : -
+============================================================================= */
+void Reset_ISR_Direct(void) __naked
+{
+__asm
+  ld   HL,(#_ISR_Reloc_dest)
+  call Reloc_Installed
+  ret  NZ            ;IF the copy of the ISR is not installed THEN exit
+
+  ld   A,I           ;P/V = IFF2 (interrupts enabled)
+  jp   PE,1$
+  ld   A,I           ;NMOS Z80: read again if an interrupt was accepted
+1$:
+  di
+  push AF
+
+  ld   HL,(#_ISR_Reloc_dest)
+  ld   DE,#ISR_Reloc_keyi+1-_ISR_Reloc
+  add  HL,DE
+  ld   (HL),#<HKEYI
+  inc  HL
+  ld   (HL),#>HKEYI
+
+  ld   HL,(#_ISR_Reloc_dest)
+  ld   DE,#ISR_Reloc_timi+1-_ISR_Reloc
+  add  HL,DE
+  ld   (HL),#<HTIMI
+  inc  HL
+  ld   (HL),#>HTIMI
+
+  pop  AF
+  ret  PO           ;IF interrupts were disabled THEN exit
+  ei
+  ret
+__endasm;
+}
+
+
+
+/* =============================================================================
+## Relocatable ISR for M1 interrupt of Z80
+
+* Same as ISR_Basic, with a relative jump instead of the JP P.
+* It is not installed from here. It is the code copied by Install_ISR_Reloc.
+============================================================================= */
+void ISR_Reloc(void) __naked
+{
+__asm
+  push   IY
+  push   IX
+  push   HL
+  push   DE
+  push   BC
+  push   AF
+
+  exx
+  ex     AF,AF
+  push   HL
+  push   DE
+  push   BC
+  push   AF
+
+
+ISR_Reloc_keyi:
+  call   HKEYI           ;Hook KEYI Not VDP Interrupt handler (RS232, MIDI, etc)
+
+  in     A,(0x99)        ;read if VDP interrupt and Disable interrupt call to CPU
+  bit    7,A
+  jr     Z,exitISRr      ;IF Not VDP Interrupt THEN exit
+
+;is a VDP Interrupt
+  ld     (STATFL),A      ;save VDP reg#0 in STATFL system variable
+
+ISR_Reloc_timi:
+  call   HTIMI           ;Hook TIMI VDP Interrupt handler
+
+;restore all Z80 registers and exit
+exitISRr:
+
+  pop    AF
+  pop    BC
+  pop    DE
+  pop    HL
+  ex     AF,AF
+  exx
+
+  pop    AF
+  pop    BC
+  pop    DE
+  pop    HL
+  pop    IX
+  pop    IY
+
+  ei
+  ret
+ISR_Reloc_end:
+__endasm;
+}
@@ -0,0 +1,339 @@
+/* =============================================================================
+Z80 interrupt Mode 1 MSX SDCC Library (fR3eL Project)
+ISR variants generator
+Version: 1.6 (17/10/2026)
+Author: mvac7/303bcn
+Architecture: MSX
+Format: C Object (SDCC .rel)
+Programming language: C and Z80 assembler
+Compiler: SDCC 4.4 or newer
+
+fR3eL Project
+https://github.com/mvac7/SDCC_MSX_fR3eL
+
+Description:
+Template to obtain, at compile time, an ISR for Z80 Mode 1 interrupts with
+only the work that the application needs.
+Each compilation of this source generates an object with a single ISR.
+The features are selected with the following macros (-D option of SDCC):
+
+  ISR_NAME           Name of the function (default ISR_Custom)
+  ISR_SAVE_ALTREGS   1 = Saves the alternate registers (AF',BC',DE',HL')
+  ISR_SAVE_INDEXREGS 1 = Saves the index registers (IX and IY)
+  ISR_CALL_KEYI      1 = Calls the KEYI hook (RS-232C, MSX-Midi, etc)
+  ISR_CALL_TIMI      1 = Calls the TIMI hook on VDP VBLANK interrupt
+  ISR_UPDATE_STATFL  1 = Saves the VDP status register 0 in STATFL
+  ISR_LINE_INT       1 = Calls LINE_HOOK on VDP line interrupt (V9938/V9958)
+  ISR_MEGAROM        1 = Saves the banks of the MegaROM (MEGAROM_banks) and
+                         selects them again on exit (see interruptM1_MegaROM.h)
+  ISR_DOS2_MAPPER    1 = Saves the segments of the memory mapper in pages 1
+                         and 2 (ports FDh and FEh) and selects them again on
+                         exit (MSX-DOS2)
+  ISR_OWN_STACK      1 = Works on its own stack (ISR_stack, see
+                         interruptM1_Stack.h) instead of the program stack
+  ISR_SHADOW_REGS    1 = Works on the alternate registers (exx, ex AF,AF')
+                         instead of saving the registers on the stack.
+                         The program must never use the alternate registers.
+  ISR_NESTED         1 = Enables the interrupts while the TIMI hook runs, so
+                         that the KEYI devices can interrupt it. The VBLANK
+                         interrupt of the VDP (IE0) is disabled meanwhile.
+                         While ISR_busy is set, a nested interrupt only calls
+                         the KEYI hook (the VDP is never read).
+                         Init_ISR_Nested clears it.
+
+All are 1 by default (except ISR_LINE_INT, ISR_MEGAROM, ISR_DOS2_MAPPER,
+ISR_OWN_STACK, ISR_SHADOW_REGS and ISR_NESTED), which generates the same code as ISR_Basic.
+If no hook is called, only the AF pair is saved.
+
+Example:
+  sdcc -mz80 -c -DISR_NAME=ISR_TIMI -DISR_CALL_KEYI=0 -o build\ISR_TIMI.rel src\interruptM1_ISRvariant.c
+============================================================================= */
+
+#include "../include/interruptM1_ISR.h"
+#include "../include/interruptM1_MegaROM.h"
+#include "../include/interruptM1_Stack.h"
+
+
+#define HKEYI	 0xFD9A //Hook KEYI. Interrupt handler device other than the VDP. (RS-232C, MSX-Midi, etc)
+#define HTIMI	 0xFD9F //Hook TIMI. Interrupt handler VDP VBLANK
+
+#define STATFL	 0xF3E7 //VDP status register 0 (system variable)
+#define RG0SAV	 0xF3DF //Mirror of VDP register 0
+#define RG1SAV	 0xF3E0 //Mirror of VDP register 1
+
+
+#ifndef ISR_NAME
+#define ISR_NAME	ISR_Custom
+#endif
+
+#ifndef ISR_SAVE_ALTREGS
+#define ISR_SAVE_ALTREGS	1
+#endif
+
+#ifndef ISR_SAVE_INDEXREGS
+#define ISR_SAVE_INDEXREGS	1
+#endif
+
+#ifndef ISR_CALL_KEYI
+#define ISR_CALL_KEYI		1
+#endif
+
+#ifndef ISR_CALL_TIMI
+#define ISR_CALL_TIMI		1
+#endif
+
+#ifndef ISR_UPDATE_STATFL
+#define ISR_UPDATE_STATFL	1
+#endif
+
+#ifndef ISR_LINE_INT
+#define ISR_LINE_INT		0
+#endif
+
+#ifndef ISR_MEGAROM
+#define ISR_MEGAROM			0
+#endif
+
+#ifndef ISR_DOS2_MAPPER
+#define ISR_DOS2_MAPPER		0
+#endif
+
+#ifndef ISR_OWN_STACK
+#define ISR_OWN_STACK		0
+#endif
+
+#ifndef ISR_SHADOW_REGS
+#define ISR_SHADOW_REGS		0
+#endif
+
+#ifndef ISR_NESTED
+#define ISR_NESTED			0
+#endif
+
+// A nested interrupt would use the same stack or the same registers.
+#if ISR_NESTED && (ISR_OWN_STACK || ISR_SHADOW_REGS)
+#error "ISR_NESTED can not be used with ISR_OWN_STACK or ISR_SHADOW_REGS"
+#endif
+
+
+// Without hooks, the ISR only uses the AF pair.
+#if ISR_CALL_KEYI || ISR_CALL_TIMI || ISR_LINE_INT || ISR_MEGAROM || ISR_DOS2_MAPPER
+#define ISR_FREE_REGS		1	//the ISR uses AF, BC, DE and HL
+#else
+#define ISR_FREE_REGS		0
+#endif
+
+// With the alternate registers, nothing is saved on the stack (except IX/IY).
+#if ISR_FREE_REGS && !ISR_SHADOW_REGS
+#define ISR_SAVE_MAINREGS	1
+#else
+#define ISR_SAVE_MAINREGS	0
+#endif
+
+
+
+#if ISR_NESTED
+char ISR_busy;		//1 = the VBLANK work is running
+
+
+
+/* =============================================================================
+ Init_ISR_Nested
+
+ Function : Clear ISR_busy. Call it before installing the nested ISR.
+ Input    : -
+ Output   : -
+============================================================================= */
+void Init_ISR_Nested(void)
+{
+	ISR_busy = 0;
+}
+#endif
+
+
+
+/* =============================================================================
+## ISR variant for M1 interrupt of Z80
+
+* Saves the Z80 registers selected in compilation.
+* Calls the selected system hooks: TIMI (VBLANK) and/or KEYI
+============================================================================= */
+void ISR_NAME(void) __naked
+{
+__asm
+#if ISR_OWN_STACK
+  ld     (#_ISR_savedSP),SP
+  ld     SP,#_ISR_stack+ISR_STACK_SIZE   ;stack of the ISR
+#endif
+#if ISR_SAVE_INDEXREGS && ISR_FREE_REGS
+  push   IY
+  push   IX
+#endif
+#if ISR_SHADOW_REGS
+  ex     AF,AF
+  exx                    ;the registers of the program are not changed
+#else
+#if ISR_SAVE_MAINREGS
+  push   HL
+  push   DE
+  push   BC
+#endif
+  push   AF
+#endif
+
+#if ISR_SAVE_ALTREGS && ISR_SAVE_MAINREGS
+  exx
+  ex     AF,AF
+  push   HL
+  push   DE
+  push   BC
+  push   AF
+#endif
+
+#if ISR_MEGAROM
+  ld     HL,(#_MEGAROM_banks+2)
+  push   HL
+  ld     HL,(#_MEGAROM_banks)
+  push   HL              ;banks selected by the main program
+#endif
+
+#if ISR_DOS2_MAPPER
+  in     A,(0xFD)
+  ld     L,A
+  in     A,(0xFE)
+  ld     H,A
+  push   HL              ;segments of pages 1 and 2 of the main program
+#endif
+
+
+#if ISR_CALL_KEYI
+  call   HKEYI           ;Hook KEYI Not VDP Interrupt handler (RS232, MIDI, etc)
+#endif
+
+#if ISR_NESTED
+;nested interrupt: the VDP is never read, the TIMI hook can be using its ports.
+;The VDP can not interrupt the VBLANK work (IE0 off), so it is a KEYI device.
+  ld     A,(#_ISR_busy)
+  or     A
+  jp     NZ,exitISRv     ;IF the VBLANK work is running THEN exit
+#endif
+
+#if ISR_LINE_INT
+  ld     A,(RG0SAV)
+  and    #0x10
+  jr     Z,noLineISRv    ;IF IE1 disabled THEN is not a line interrupt
+
+  ld     A,#1
+  out    (0x99),A
+  ld     A,#0x8F
+  out    (0x99),A        ;R#15 = 1 (status register 1)
+  in     A,(0x99)        ;read S#1 and clear FH
+  ld     B,A
+  xor    A
+  out    (0x99),A
+  ld     A,#0x8F
+  out    (0x99),A        ;R#15 = 0 (status register 0)
+
+  bit    0,B
+  jr     Z,noLineISRv    ;IF FH=0 THEN is not a line interrupt
+
+  call   _LINE_HOOK      ;VDP line interrupt handler
+
+noLineISRv:
+#endif
+
+  in     A,(0x99)        ;read if VDP interrupt and Disable interrupt call to CPU
+#if ISR_CALL_TIMI || ISR_UPDATE_STATFL
+  and    A
+  jp     P,exitISRv      ;IF Not VDP Interrupt THEN exit
+
+;is a VDP Interrupt
+#endif
+#if ISR_UPDATE_STATFL
+  ld     (STATFL),A      ;save VDP reg#0 in STATFL system variable
+#endif
+
+#if ISR_CALL_TIMI
+#if ISR_NESTED
+  ld     B,A             ;VDP status
+  ld     A,#1
+  ld     (#_ISR_busy),A
+  ld     A,(RG1SAV)
+  and    #0xDF
+  out    (0x99),A
+  ld     A,#0x81
+  out    (0x99),A        ;R#1 without IE0: the VDP can not interrupt the hook
+  ld     A,B             ;the TIMI hook receives the VDP status
+  ei                     ;only the KEYI devices can interrupt
+#endif
+  call   HTIMI           ;Hook TIMI VDP Interrupt handler
+#if ISR_NESTED
+  di
+  ld     A,(RG1SAV)
+  out    (0x99),A
+  ld     A,#0x81
+  out    (0x99),A        ;R#1 = RG1SAV (IE0 again)
+  xor    A
+  ld     (#_ISR_busy),A
+#endif
+#endif
+
+;restore Z80 registers and exit
+exitISRv:
+
+#if ISR_DOS2_MAPPER
+  pop    HL
+  ld     A,L
+  out    (0xFD),A
+  ld     A,H
+  out    (0xFE),A
+#endif
+
+#if ISR_MEGAROM
+  pop    HL
+  ld     (#_MEGAROM_banks),HL
+  ld     A,L
+  ld     (#MEGAROM_SEL0),A
+  ld     A,H
+  ld     (#MEGAROM_SEL1),A
+  pop    HL
+  ld     (#_MEGAROM_banks+2),HL
+  ld     A,L
+  ld     (#MEGAROM_SEL2),A
+  ld     A,H
+  ld     (#MEGAROM_SEL3),A
+#endif
+
+#if ISR_SAVE_ALTREGS && ISR_SAVE_MAINREGS
+  pop    AF
+  pop    BC
+  pop    DE
+  pop    HL
+  ex     AF,AF
+  exx
+#endif
+
+#if ISR_SHADOW_REGS
+  exx
+  ex     AF,AF
+#else
+  pop    AF
+#if ISR_SAVE_MAINREGS
+  pop    BC
+  pop    DE
+  pop    HL
+#endif
+#endif
+#if ISR_SAVE_INDEXREGS && ISR_FREE_REGS
+  pop    IX
+  pop    IY
+#endif
+
+#if ISR_OWN_STACK
+  ld     SP,(#_ISR_savedSP)  ;stack of the main program
+#endif
+
+  ei
+  ret
+__endasm;
+}
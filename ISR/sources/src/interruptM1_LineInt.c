@@ -0,0 +1,142 @@
+/* =============================================================================
+Z80 interrupt Mode 1 VDP Line interrupt MSX SDCC Library (fR3eL Project)
+Version: 1.1 (17/10/2026)
+Author: mvac7/303bcn
+Architecture: MSX2 or higher (V9938/V9958)
+Format: C Object (SDCC .rel)
+Programming language: C and Z80 assembler
+Compiler: SDCC 4.4 or newer
+
+fR3eL Project
+https://github.com/mvac7/SDCC_MSX_fR3eL
+
+Description:
+Control of the line interrupt (IE1) of the V9938/V9958 VDP.
+The ISR compiled with ISR_LINE_INT (ISR_Line) reads the FH flag of the status
+register 1 and calls LINE_HOOK. The VBLANK is still handled by the TIMI hook.
+LINE_HOOK is not initialised by the crt0 files: call Init_LineInt before
+installing ISR_Line.
+
+History of versions:
+- v1.1 (17/10/2026) Init_LineInt (LINE_HOOK to RET)
+- v1.0 (17/10/2026) First version
+============================================================================= */
+
+#include "../include/interruptM1_ISR.h"
+#include "../include/interruptM1_LineInt.h"
+
+
+#define RG0SAV	 0xF3DF //Mirror of VDP register 0
+#define RG19SAV	 0xFFF2 //Mirror of VDP register 19
+
+#define JP_CODE	 0xC3
+#define RET_CODE 0xC9
+
+
+char LINE_HOOK[3];
+
+
+void Set_LineIntVDP(char reg, char value);
+
+
+
+
+/* =============================================================================
+ Init_LineInt
+
+ Function : Initialize the hook of the line interrupt (RET).
+            Call it before installing ISR_Line.
+ Input    : -
+ Output   : -
+============================================================================= */
+void Init_LineInt(void)
+{
+	LINE_HOOK[0] = RET_CODE;
+}
+
+
+
+/* =============================================================================
+ Install_LineInt
+
+ Function : Set the function of the line interrupt and enable it (IE1)
+ Input    : [func] Function address
+            [line] line number (VDP R#19)
+ Output   : -
+============================================================================= */
+void Install_LineInt(void (*func)(void), char line)
+{
+	EnterCritical();
+
+	LINE_HOOK[0] = JP_CODE;
+	*(unsigned int*)(LINE_HOOK+1) = (unsigned int)func;
+
+	*(char*)RG19SAV = line;
+	Set_LineIntVDP(19, line);
+
+	*(char*)RG0SAV |= 0x10;		//IE1 on
+	Set_LineIntVDP(0, *(char*)RG0SAV);
+
+	ExitCritical();
+}
+
+
+
+/* =============================================================================
+ Set_LineInt
+
+ Function : Change the line of the interrupt (VDP R#19)
+ Input    : [line] line number
+ Output   : -
+============================================================================= */
+void Set_LineInt(char line)
+{
+	EnterCritical();
+	*(char*)RG19SAV = line;
+	Set_LineIntVDP(19, line);
+	ExitCritical();
+}
+
+
+
+/* =============================================================================
+ Disable_LineInt
+
+ Function : Disable the line interrupt (IE1) and its hook
+ Input    : -
+ Output   : -
+============================================================================= */
+void Disable_LineInt(void)
+{
+	EnterCritical();
+
+	*(char*)RG0SAV &= ~0x10;	//IE1 off
+	Set_LineIntVDP(0, *(char*)RG0SAV);
+
+	LINE_HOOK[0] = RET_CODE;
+
+	ExitCritical();
+}
+
+
+
+/* -----------------------------------------------------------------------------
+ Set_LineIntVDP
+
+ Write a VDP register. Call it with interrupts disabled.
+ Input: [A] register; [L] value
+----------------------------------------------------------------------------- */
+void Set_LineIntVDP(char reg, char value) __naked
+{
+reg;	//A
+value;	//L
+__asm
+  ld   C,A
+  ld   A,L
+  out  (0x99),A
+  ld   A,C
+  or   #0x80
+  out  (0x99),A
+  ret
+__endasm;
+}
@@ -0,0 +1,116 @@
+/* =============================================================================
+Z80 interrupt Mode 1 MegaROM banks MSX SDCC Library (fR3eL Project)
+Version: 1.0 (17/10/2026)
+Author: mvac7/303bcn
+Architecture: MSX
+Format: C Object (SDCC .rel)
+Programming language: C and Z80 assembler
+Compiler: SDCC 4.4 or newer
+
+fR3eL Project
+https://github.com/mvac7/SDCC_MSX_fR3eL
+
+Description:
+The bank registers of the MegaROM mappers (ASCII8, Konami SCC) can not be
+read. The library keeps a copy of each one in RAM (MEGAROM_banks), so that an
+ISR compiled with ISR_MEGAROM can save them on entry and select them again
+on exit. The handlers of the interrupt can change the banks freely.
+
+The copy is always written before the register. If an interrupt arrives
+between the two writes, the ISR restores the new bank.
+
+Compile with -DMEGAROM_KONAMI_SCC for the Konami SCC mapper (ASCII8 by
+default).
+
+History of versions:
+- v1.0 (17/10/2026) First version
+============================================================================= */
+
+#include "../include/interruptM1_MegaROM.h"
+
+
+// Bank register of Call_Banked
+#if MEGAROM_CALL_PAGE==0
+#define MEGAROM_CALL_SEL	MEGAROM_SEL0
+#elif MEGAROM_CALL_PAGE==1
+#define MEGAROM_CALL_SEL	MEGAROM_SEL1
+#elif MEGAROM_CALL_PAGE==3
+#define MEGAROM_CALL_SEL	MEGAROM_SEL3
+#else
+#define MEGAROM_CALL_SEL	MEGAROM_SEL2
+#endif
+
+
+char MEGAROM_banks[4];
+
+char* const MEGAROM_select[4] = {(char*)MEGAROM_SEL0, (char*)MEGAROM_SEL1,
+                                 (char*)MEGAROM_SEL2, (char*)MEGAROM_SEL3};
+
+
+
+
+/* =============================================================================
+ Init_Banks
+
+ Function : Initialize the banks as the mapper at start: 0, 1, 2, 3
+ Input    : -
+ Output   : -
+============================================================================= */
+void Init_Banks(void)
+{
+	char page;
+
+	for (page=0;page<4;page++) Set_Bank(page, page);
+}
+
+
+
+/* =============================================================================
+ Set_Bank
+
+ Function : Select a bank in a register of the mapper and save it
+ Input    : [page] register of the mapper (0 to 3 = 0x4000 to 0xA000)
+            [bank] bank number
+ Output   : -
+============================================================================= */
+void Set_Bank(char page, char bank)
+{
+	MEGAROM_banks[page] = bank;
+	*MEGAROM_select[page] = bank;
+}
+
+
+
+/* =============================================================================
+ Call_Banked
+
+ Function : Call a function of a bank, selected in the register
+            MEGAROM_CALL_PAGE, and select the previous bank at the end.
+ Input    : [bank] bank number
+            [func] Function address
+ Output   : -
+============================================================================= */
+void Call_Banked(char bank, void (*func)(void)) __naked
+{
+bank;	//A
+func;	//DE
+__asm
+  ld   HL,#_MEGAROM_banks+MEGAROM_CALL_PAGE
+  ld   C,(HL)        ;previous bank
+  push BC
+  ld   (HL),A
+  ld   (#MEGAROM_CALL_SEL),A
+
+  ex   DE,HL
+  call 1$
+
+  pop  BC
+  ld   A,C
+  ld   (#_MEGAROM_banks+MEGAROM_CALL_PAGE),A
+  ld   (#MEGAROM_CALL_SEL),A
+  ret
+
+1$:
+  jp   (HL)
+__endasm;
+}
@@ -0,0 +1,392 @@
+/* =============================================================================
+Z80 interrupt Mode 1 Page 0 RAM MSX SDCC Library (fR3eL Project)
+Version: 1.0 (17/10/2026)
+Author: mvac7/303bcn
+Architecture: MSX
+Format: C Object (SDCC .rel)
+Programming language: C and Z80 assembler
+Compiler: SDCC 4.4 or newer
+
+fR3eL Project
+https://github.com/mvac7/SDCC_MSX_fR3eL
+
+Description:
+For ROM cartridges (48K and MegaROM) that do not need the BIOS ISR.
+Page 0 is switched to the RAM of the same slot as page 3 (the RAM used by the
+system variables), and a minimal vector page is written with the ISR of the
+program. The BIOS interrupt routine (KEYINT) is not executed anymore.
+
+The secondary slot register (0xFFFF) only selects the subslot of the primary
+slot of page 3, so:
+- The subslot of the RAM is always selected from 0xFFFF.
+- The subslot of the BIOS is only selected when it is in the same primary
+  slot as the RAM. Otherwise, it is not changed and remains as the BIOS left it.
+SLTTBL is updated with each change of 0xFFFF, so that the inter-slot calls of
+the BIOS keep working.
+
+The program must not be in page 0 (the ROM of a cartridge starts at 0x4000).
+
+History of versions:
+- v1.0 (17/10/2026) First version
+============================================================================= */
+
+#include "../include/interruptM1_Page0.h"
+
+
+#define HINT     0x0038 //Z80 INT (RST $38)  - M1 Interrupt vector
+#define CALSLT   0x001C //BIOS inter-slot call
+#define CALLF    0x0030 //BIOS inter-slot call with inline slot and address (RST 30h)
+#define NMI      0x0066 //Z80 NMI
+
+#define EXPTBL   0xFCC1 //Slot of the main BIOS-ROM and expanded flags (4B)
+#define SLTTBL   0xFCC5 //Mirror of the secondary slot registers (4B)
+
+
+// Selection of page 0: primary slot, subslot (0xFF = not changed), SLTTBL
+char PAGE0_RAM[4];
+char PAGE0_BIOS[4];
+
+
+void Page0_Select(void);
+void Page0_Set(void);
+
+
+
+
+/* =============================================================================
+ Init_Page0RAM
+
+ Function : Switch page 0 to the RAM slot of page 3 and build a minimal
+            vector page (install the hooks before)
+ Input    : [isr] Function address
+ Output   : 1 = page 0 in RAM; 0 = no RAM for page 0
+============================================================================= */
+char Init_Page0RAM(ISR_FUNC isr) __naked
+{
+isr;	//HL
+__asm
+  push HL
+
+  ld   A,I           ;P/V = IFF2 (interrupts enabled)
+  jp   PE,1$
+  ld   A,I           ;NMOS Z80: read again if an interrupt was accepted
+1$:
+  di
+  push AF
+
+; slot of the RAM of page 3
+  in   A,(0xA8)
+  rlca
+  rlca
+  and  #3
+  ld   C,A           ;C = primary slot
+  ld   HL,#EXPTBL
+  add  A,L
+  ld   L,A
+  ld   B,#0xFF       ;B = subslot (not expanded)
+  bit  7,(HL)
+  jr   Z,2$
+  ld   A,(#0xFFFF)
+  cpl
+  rlca
+  rlca
+  and  #3
+  ld   B,A
+2$:
+  ld   HL,#_PAGE0_RAM
+  call Page0_Config
+
+; slot of the BIOS
+  ld   A,(#EXPTBL)
+  ld   B,#0xFF
+  and  #3
+  cp   C
+  ld   C,A           ;C = primary slot
+  jr   NZ,3$         ;IF not in the primary slot of page 3 THEN not the subslot
+  ld   A,(#EXPTBL)
+  rrca
+  rrca
+  and  #3
+  ld   B,A
+3$:
+  ld   HL,#_PAGE0_BIOS
+  call Page0_Config
+
+; switch page 0 to RAM and check it
+  ld   HL,#_PAGE0_RAM
+  call _Page0_Set
+  ld   HL,#0
+  ld   (HL),#0x55
+  ld   A,(HL)
+  cp   #0x55
+  jr   NZ,noRAM_Page0
+  ld   (HL),#0xAA
+  ld   A,(HL)
+  cp   #0xAA
+  jr   NZ,noRAM_Page0
+
+; vector page
+  ld   DE,#8
+  ld   B,#6
+4$:
+  ld   (HL),#0xC9    ;RET in RST 00h to RST 28h
+  add  HL,DE
+  djnz 4$
+
+  ld   A,#0xC3       ;JP
+  ld   (#CALSLT),A
+  ld   HL,#_Page0_CALSLT
+  ld   (#CALSLT+1),HL
+  ld   (#CALLF),A    ;the hooks of the disk and other ROMs use RST 30h
+  ld   HL,#_Page0_CALLF
+  ld   (#CALLF+1),HL
+
+  ld   HL,#0x45ED    ;RETN
+  ld   (#NMI),HL
+
+  pop  BC            ;BC = interrupts state
+  pop  HL            ;HL = isr
+  push BC
+  ld   (#HINT),A
+  ld   (#HINT+1),HL
+
+  pop  AF
+  ld   A,#1
+  ret  PO           ;IF interrupts were disabled THEN exit
+  ei
+  ret
+
+noRAM_Page0:
+  ld   HL,#_PAGE0_BIOS
+  call _Page0_Set
+
+  pop  BC            ;BC = interrupts state
+  pop  HL
+  push BC
+
+  pop  AF
+  ld   A,#0
+  ret  PO           ;IF interrupts were disabled THEN exit
+  ei
+  ret
+
+
+; HL = selection; C = primary slot; B = subslot
+Page0_Config:
+  ld   (HL),C
+  inc  HL
+  ld   (HL),B
+  inc  HL
+  ld   A,C
+  add  A,#<SLTTBL
+  ld   (HL),A
+  inc  HL
+  ld   (HL),#>SLTTBL
+  ret
+__endasm;
+}
+
+
+
+/* =============================================================================
+ Page0_BIOS
+
+ Function : Switch page 0 to the BIOS (main ROM)
+ Input    : -
+ Output   : -
+============================================================================= */
+void Page0_BIOS(void) __naked
+{
+__asm
+  ld   HL,#_PAGE0_BIOS
+  jp   _Page0_Select
+__endasm;
+}
+
+
+
+/* =============================================================================
+ Page0_RAM
+
+ Function : Switch page 0 to the RAM selected by Init_Page0RAM
+ Input    : -
+ Output   : -
+============================================================================= */
+void Page0_RAM(void) __naked
+{
+__asm
+  ld   HL,#_PAGE0_RAM
+  jp   _Page0_Select
+__endasm;
+}
+
+
+
+/* -----------------------------------------------------------------------------
+ Page0_Select
+ Input: HL = selection (PAGE0_RAM or PAGE0_BIOS)
+----------------------------------------------------------------------------- */
+void Page0_Select(void) __naked
+{
+__asm
+  ld   A,I           ;P/V = IFF2 (interrupts enabled)
+  jp   PE,1$
+  ld   A,I           ;NMOS Z80: read again if an interrupt was accepted
+1$:
+  di
+  push AF
+  call _Page0_Set
+  pop  AF
+  ret  PO           ;IF interrupts were disabled THEN exit
+  ei
+  ret
+__endasm;
+}
+
+
+
+/* -----------------------------------------------------------------------------
+ Page0_Set
+ Input: HL = selection (PAGE0_RAM or PAGE0_BIOS)
+ Interrupts must be disabled. Changes AF and HL.
+----------------------------------------------------------------------------- */
+void Page0_Set(void) __naked
+{
+__asm
+  in   A,(0xA8)
+  and  #0xFC
+  or   (HL)
+  out  (0xA8),A      ;primary slot of page 0
+  inc  HL
+  ld   A,(HL)
+  cp   #0xFF
+  ret  Z             ;IF subslot not changed THEN exit
+
+  push BC
+  push DE
+  ld   B,A
+  inc  HL
+  ld   E,(HL)
+  inc  HL
+  ld   D,(HL)        ;DE = SLTTBL of the slot
+  ld   A,(#0xFFFF)
+  cpl
+  and  #0xFC
+  or   B
+  ld   (#0xFFFF),A   ;subslot of page 0
+  ld   (DE),A
+  pop  DE
+  pop  BC
+  ret
+__endasm;
+}
+
+
+
+/* =============================================================================
+ Page0_CALSLT
+
+ Function : Inter-slot call with page 0 in RAM (for assembler)
+ Input    : IY (high byte) slot; IX address; AF, BC, DE, HL for the routine
+ Output   : AF, BC, DE, HL of the routine
+============================================================================= */
+void Page0_CALSLT(void) __naked
+{
+__asm
+  push HL
+  push AF
+
+  ld   A,I           ;P/V = IFF2 (interrupts enabled)
+  jp   PE,1$
+  ld   A,I           ;NMOS Z80: read again if an interrupt was accepted
+1$:
+  di
+  push AF
+
+  ld   HL,#_PAGE0_BIOS
+  call _Page0_Set
+
+  pop  HL            ;HL = interrupts state
+  pop  AF
+  ex   (SP),HL       ;restore HL and keep the interrupts state
+  call CALSLT        ;BIOS inter-slot call (the BIOS ISR attends the interrupts)
+  ex   (SP),HL
+  push AF
+  push HL
+
+  di
+  ld   HL,#_PAGE0_RAM
+  call _Page0_Set
+
+  pop  AF            ;interrupts state
+  jp   PO,2$
+  pop  AF
+  pop  HL
+  ei
+  ret
+2$:
+  pop  AF
+  pop  HL
+  ret
+__endasm;
+}
+
+
+
+/* =============================================================================
+ Page0_CALLF
+
+ Function : Inter-slot call of RST 30h with page 0 in RAM (for assembler).
+            Init_Page0RAM places a JP to it at 0x0030, so the hooks with an
+            inter-slot call (RST 30h, slot, address) keep working.
+ Input    : slot (1 byte) and address (2 bytes) after the RST 30h;
+            AF, BC, DE, HL for the routine
+ Output   : AF, BC, DE, HL of the routine. Changes IX and IY (as the BIOS).
+============================================================================= */
+void Page0_CALLF(void) __naked
+{
+__asm
+  ex   (SP),HL       ;HL = data after the RST 30h
+  push AF
+  push DE
+  ld   A,(HL)
+  push AF
+  pop  IY            ;IYh = slot
+  inc  HL
+  ld   E,(HL)
+  inc  HL
+  ld   D,(HL)
+  inc  HL
+  push DE
+  pop  IX            ;IX = address
+  pop  DE
+  pop  AF
+  ex   (SP),HL       ;return after the data and restore HL
+  jp   _Page0_CALSLT
+__endasm;
+}
+
+
+
+/* =============================================================================
+ Call_BIOS
+
+ Function : Call a BIOS routine without parameters with page 0 in RAM
+ Input    : [address] address of the BIOS routine
+ Output   : -
+============================================================================= */
+void Call_BIOS(unsigned int address) __naked
+{
+address;	//HL
+__asm
+  push IX
+  push IY
+  push HL
+  pop  IX
+  ld   IY,(#EXPTBL-1)   ;IYh = slot of the main BIOS-ROM
+  call _Page0_CALSLT
+  pop  IY
+  pop  IX
+  ret
+__endasm;
+}
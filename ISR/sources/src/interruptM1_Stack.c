@@ -0,0 +1,67 @@
+/* =============================================================================
+Z80 interrupt Mode 1 ISR Stack MSX SDCC Library (fR3eL Project)
+Version: 1.0 (17/10/2026)
+Author: mvac7/303bcn
+Architecture: MSX
+Format: C Object (SDCC .rel)
+Programming language: C
+Compiler: SDCC 4.4 or newer
+
+fR3eL Project
+https://github.com/mvac7/SDCC_MSX_fR3eL
+
+Description:
+Stack for the ISR compiled with ISR_OWN_STACK. The ISR saves the SP of the
+main program in ISR_savedSP, works on ISR_stack and restores the SP on exit,
+so the stack of the main program only receives the return address (2 bytes).
+
+The stack is filled with a known value. The bytes that no longer have it have
+been used, so the deepest one gives the maximum use (high-water mark).
+
+History of versions:
+- v1.0 (17/10/2026) First version
+============================================================================= */
+
+#include "../include/interruptM1_Stack.h"
+
+
+char ISR_stack[ISR_STACK_SIZE];
+unsigned int ISR_savedSP;	//SP of the main program
+
+
+
+
+/* =============================================================================
+ Init_ISRStack
+
+ Function : Fill the stack of the ISR with ISR_STACK_FILL
+ Input    : -
+ Output   : -
+============================================================================= */
+void Init_ISRStack(void)
+{
+	char* pos = ISR_stack;
+	unsigned int i;
+
+	for (i=ISR_STACK_SIZE;i>0;i--) *pos++ = ISR_STACK_FILL;
+}
+
+
+
+/* =============================================================================
+ Get_ISRStackPeak
+
+ Function : Returns the maximum number of bytes used in the stack of the ISR
+ Input    : -
+ Output   : [unsigned int] bytes
+============================================================================= */
+unsigned int Get_ISRStackPeak(void)
+{
+	char* pos = ISR_stack;
+	unsigned int free = 0;
+
+	// the stack grows down: the free bytes are at the start
+	while (free < ISR_STACK_SIZE && *pos++ == ISR_STACK_FILL) free++;
+
+	return ISR_STACK_SIZE - free;
+}
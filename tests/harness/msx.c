@@ -0,0 +1,678 @@
+/* =============================================================================
+MSX test harness (fR3eL Project)
+Runs an MSX-DOS program (.ihx built with SDCC, or .COM) on the Z80 core with
+a minimal MSX machine:
+- 128K of memory mapper RAM in the four pages (ports 0xFC-0xFF).
+- VDP status registers S#0 and S#1, registers R#0, R#1, R#15, R#19 and R#23
+  (port 0x99), with the VBLANK interrupt every frame and the line interrupt.
+- Hooks area filled with RET and a BIOS ISR in page 0 (RST 38h) that calls
+  KEYI and TIMI as the MSX BIOS does.
+- MSX-DOS functions 0x00, 0x02, 0x09 and 0x62 (terminate with error code).
+- Test ports: 0x2B raises/acknowledges a device interrupt (KEYI),
+  0x2E writes a character and 0x2F ends the program with an exit code.
+- Benchmark ports: 0x2C sets the probe address and 0x2D measures a call to
+  the probe or the next interrupt and prints the result (Z80 and MSX T-states,
+  or R800 cycles with -r).
+The exit code of the harness is the exit code of the program; 124 if the
+program does not end in the time limit, 125 on an emulation error.
+https://github.com/mvac7/SDCC_MSX_fR3eL
+============================================================================= */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "z80.h"
+
+
+#define SEGMENTS		8
+#define SEGMENT_SIZE	0x4000
+
+#define BDOS			0x0005
+#define HINT			0x0038
+#define BIOS_ISR		0x0040
+#define TPA_TOP			0xDC00
+#define RG1SAV			0xF3E0	// mirror of R#1 (system variable)
+#define HOOKS_START		0xFD9A
+#define HOOKS_END		0xFFCA
+
+#define PORT_DEVICE		0x2B	// out: 0 = release, other = raise a device interrupt
+								// in : device interrupt state (and acknowledge)
+#define PORT_PROBE		0x2C	// out: address of the probe (low byte, high byte)
+#define PORT_BENCH		0x2D	// out: BENCH_* command
+#define PORT_PUTCHAR	0x2E
+#define PORT_EXIT		0x2F
+
+#define LINE_CYCLES		228		// T-states of the Z80 at 3.58 MHz
+#define R800_CLOCK		2		// R800 cycles (7.16 MHz) in a T-state of the Z80
+#define NTSC_LINES		262
+#define PAL_LINES		313
+
+// Commands of PORT_BENCH
+#define BENCH_CALL		1	// measure the next call to the probe
+#define BENCH_INT		2	// measure the next interrupt
+#define BENCH_TOTAL		3	// print the total of the last measure
+#define BENCH_DI		4	// print the longest DI window of the last measure
+#define BENCH_ENTRY		5	// print the time from the interrupt to the probe
+
+#define BENCH_IDLE		0
+#define BENCH_ARMED		1
+#define BENCH_RUNNING	2
+#define BENCH_DONE		3
+
+#define EXIT_TIMEOUT	124
+#define EXIT_ERROR		125
+
+
+// Time in T-states of the Z80 and number of M1 cycles (MSX = t + m1), and
+// R800 cycles without page breaks
+typedef struct {
+	uint64_t  t;
+	uint64_t  m1;
+	uint64_t  r800;
+} STAMP;
+
+typedef struct {
+	int       mode;			// BENCH_CALL or BENCH_INT
+	int       state;		// BENCH_IDLE, BENCH_ARMED, BENCH_RUNNING or BENCH_DONE
+	uint16_t  probe;
+	int       probe_high;	// next write to PORT_PROBE is the high byte
+	uint16_t  ret;			// return address of the measured code
+	uint16_t  sp;			// SP with the return address
+	STAMP     start;
+	STAMP     entry;		// probe reached (BENCH_INT)
+	int       entered;
+	STAMP     end;
+	STAMP     di_start;
+	int       di_open;
+	STAMP     di_window;	// longest DI window
+} BENCH;
+
+typedef struct {
+	Z80       cpu;
+	uint8_t   ram[SEGMENTS][SEGMENT_SIZE];
+	uint8_t   mapper[4];
+	uint8_t   slot;
+
+	uint8_t   vdp_reg[64];
+	uint8_t   vdp_status0;
+	uint8_t   vdp_fh;
+	uint8_t   vdp_latch;
+	uint8_t   vdp_latched;
+	int       lines;
+	uint64_t  frame_start;
+	uint64_t  next_frame;
+	uint64_t  line_time;
+
+	uint8_t   device_int;
+	int       wait_m1;
+	int       r800;			// time in R800 cycles (turbo R)
+	uint64_t  line_cycles;	// cycles of a line in the time base
+
+	BENCH     bench;
+
+	int       exit_code;
+	int       finished;
+} MSX;
+
+
+// RST 38h of the MSX BIOS: saves all the registers, calls H.KEYI, reads the
+// VDP status and, on VBLANK, calls H.TIMI and stores A in STATFL after it
+// (the TIMI hook must keep A, as in the BIOS)
+static const uint8_t bios_isr[] = {
+	0xE5, 0xD5, 0xC5, 0xF5,			// push HL / push DE / push BC / push AF
+	0xD9, 0x08,						// exx / ex AF,AF'
+	0xE5, 0xD5, 0xC5, 0xF5,			// push HL / push DE / push BC / push AF
+	0xFD, 0xE5, 0xDD, 0xE5,			// push IY / push IX
+	0xCD, 0x9A, 0xFD,				// call H.KEYI
+	0xDB, 0x99,						// in   A,(0x99)
+	0xA7,							// and  A
+	0xF2, 0x5D, 0x00,				// jp   P,exit
+	0xCD, 0x9F, 0xFD,				// call H.TIMI
+	0x32, 0xE7, 0xF3,				// ld   (STATFL),A
+	0xDD, 0xE1, 0xFD, 0xE1,			// exit: pop IX / pop IY
+	0xF1, 0xC1, 0xD1, 0xE1,			// pop AF / pop BC / pop DE / pop HL
+	0x08, 0xD9,						// ex AF,AF' / exx
+	0xF1, 0xC1, 0xD1, 0xE1,			// pop AF / pop BC / pop DE / pop HL
+	0xFB, 0xC9						// ei / ret
+};
+
+
+
+static void bench_command(MSX* m, uint8_t command);
+
+
+
+static uint8_t* address_of(MSX* m, uint16_t address)
+{
+	return &m->ram[m->mapper[address >> 14] % SEGMENTS][address & (SEGMENT_SIZE - 1)];
+}
+
+static uint8_t mem_read(void* ctx, uint16_t address)
+{
+	return *address_of((MSX*)ctx, address);
+}
+
+static void mem_write(void* ctx, uint16_t address, uint8_t value)
+{
+	*address_of((MSX*)ctx, address) = value;
+}
+
+
+
+static uint64_t now(MSX* m)
+{
+	if (m->r800) return m->cpu.r800;
+	return m->cpu.cycles + (m->wait_m1 ? m->cpu.m1 : 0);
+}
+
+// Time of the line interrupt in the current frame (R#19, scrolled by R#23)
+static void schedule_line(MSX* m)
+{
+	int display = (m->vdp_reg[9] & 0x80) ? 212 : 192;
+	int line = (m->vdp_reg[19] - m->vdp_reg[23]) & 0xFF;
+	int offset = ((line - display) % m->lines + m->lines) % m->lines;
+	m->line_time = m->frame_start + (uint64_t)offset * m->line_cycles;
+	if (m->line_time < now(m)) m->line_time += (uint64_t)m->lines * m->line_cycles;
+}
+
+static void update_vdp(MSX* m)
+{
+	uint64_t t = now(m);
+	while (t >= m->next_frame)
+	{
+		m->vdp_status0 |= 0x80;
+		m->frame_start = m->next_frame;
+		m->next_frame += (uint64_t)m->lines * m->line_cycles;
+		schedule_line(m);
+	}
+	if (t >= m->line_time)
+	{
+		m->vdp_fh = 1;
+		m->line_time += (uint64_t)m->lines * m->line_cycles;
+	}
+}
+
+static int int_line(MSX* m)
+{
+	return ((m->vdp_status0 & 0x80) && (m->vdp_reg[1] & 0x20))
+		|| (m->vdp_fh && (m->vdp_reg[0] & 0x10))
+		|| m->device_int;
+}
+
+
+
+static uint8_t io_read(void* ctx, uint16_t port)
+{
+	MSX* m = (MSX*)ctx;
+	uint8_t value;
+
+	switch (port & 0xFF)
+	{
+		case 0x99:
+			m->vdp_latched = 0;
+			switch (m->vdp_reg[15] & 0x0F)
+			{
+				case 0:
+					value = m->vdp_status0;
+					m->vdp_status0 &= 0x7F;
+					return value;
+				case 1:
+					value = m->vdp_fh;
+					m->vdp_fh = 0;
+					return value;
+				default:
+					return 0;
+			}
+		case 0xA8:
+			return m->slot;
+		case 0xFC:
+		case 0xFD:
+		case 0xFE:
+		case 0xFF:
+			return (uint8_t)(m->mapper[(port & 0xFF) - 0xFC] | (0xFF & ~(SEGMENTS - 1)));
+		case PORT_DEVICE:
+			value = m->device_int;
+			m->device_int = 0;
+			return value;
+		default:
+			return 0xFF;
+	}
+}
+
+static void io_write(void* ctx, uint16_t port, uint8_t value)
+{
+	MSX* m = (MSX*)ctx;
+
+	switch (port & 0xFF)
+	{
+		case 0x99:
+			if (!m->vdp_latched)
+			{
+				m->vdp_latch = value;
+				m->vdp_latched = 1;
+				break;
+			}
+			m->vdp_latched = 0;
+			if ((value & 0xC0) == 0x80)
+			{
+				m->vdp_reg[value & 0x3F] = m->vdp_latch;
+				schedule_line(m);
+			}
+			break;
+		case 0xA8:
+			m->slot = value;
+			break;
+		case 0xFC:
+		case 0xFD:
+		case 0xFE:
+		case 0xFF:
+			m->mapper[(port & 0xFF) - 0xFC] = value & (SEGMENTS - 1);
+			break;
+		case PORT_DEVICE:
+			m->device_int = value ? 1 : 0;
+			break;
+		case PORT_PROBE:
+			if (m->bench.probe_high) m->bench.probe = (uint16_t)((m->bench.probe & 0x00FF) | (value << 8));
+			else m->bench.probe = (uint16_t)((m->bench.probe & 0xFF00) | value);
+			m->bench.probe_high ^= 1;
+			break;
+		case PORT_BENCH:
+			bench_command(m, value);
+			break;
+		case PORT_PUTCHAR:
+			putchar(value);
+			break;
+		case PORT_EXIT:
+			m->exit_code = value;
+			m->finished = 1;
+			break;
+		default:
+			break;
+	}
+}
+
+
+
+// ------------------------------------------------------------------ Benchmark
+// A call is measured from the CALL to the probe to the RET to the caller. An
+// interrupt is measured from the acknowledge (RST 38h) to the return to the
+// interrupted code; the interrupts accepted inside it are included.
+// The DI window of a call goes from the DI to the EI, both included (a DI
+// without EI, as in EnterCritical, is not a window); the one of an interrupt
+// goes from the acknowledge until an interrupt can be accepted.
+
+static STAMP stamp(MSX* m)
+{
+	STAMP s;
+	s.t = m->cpu.cycles;
+	s.m1 = m->cpu.m1;
+	s.r800 = m->cpu.r800;
+	return s;
+}
+
+static STAMP elapsed(STAMP from, STAMP to)
+{
+	STAMP s;
+	s.t = to.t - from.t;
+	s.m1 = to.m1 - from.m1;
+	s.r800 = to.r800 - from.r800;
+	return s;
+}
+
+static uint64_t stamp_time(MSX* m, STAMP s)
+{
+	return m->r800 ? s.r800 : s.t;
+}
+
+static void print_stamp(MSX* m, STAMP s)
+{
+	if (m->r800) printf("%llu", (unsigned long long)s.r800);
+	else printf("%llu (%llu)", (unsigned long long)s.t, (unsigned long long)(s.t + s.m1));
+}
+
+static void close_di(MSX* m, STAMP now)
+{
+	BENCH* b = &m->bench;
+	STAMP window = elapsed(b->di_start, now);
+	if (stamp_time(m, window) > stamp_time(m, b->di_window)) b->di_window = window;
+	b->di_open = 0;
+}
+
+static void bench_command(MSX* m, uint8_t command)
+{
+	BENCH* b = &m->bench;
+
+	switch (command)
+	{
+		case BENCH_CALL:
+		case BENCH_INT:
+			b->mode = command;
+			b->state = BENCH_ARMED;
+			b->entered = 0;
+			b->di_open = 0;
+			b->di_window.t = b->di_window.m1 = b->di_window.r800 = 0;
+			return;
+		case BENCH_TOTAL:
+			if (b->state == BENCH_DONE) print_stamp(m, elapsed(b->start, b->end));
+			else printf("---");
+			return;
+		case BENCH_DI:
+			if (b->state == BENCH_DONE && stamp_time(m, b->di_window)) print_stamp(m, b->di_window);
+			else printf("---");
+			return;
+		case BENCH_ENTRY:
+			if (b->state == BENCH_DONE && b->entered) print_stamp(m, elapsed(b->start, b->entry));
+			else printf("---");
+			return;
+		default:
+			return;
+	}
+}
+
+// Interrupt accepted: [before] time and [pc] address before the acknowledge
+static void bench_interrupt(MSX* m, STAMP before, uint16_t pc)
+{
+	BENCH* b = &m->bench;
+
+	if (b->mode != BENCH_INT || b->state != BENCH_ARMED) return;
+	b->state = BENCH_RUNNING;
+	b->start = before;
+	b->ret = pc;
+	b->sp = m->cpu.sp;
+	b->di_start = before;
+	b->di_open = 1;
+}
+
+// Instruction executed: [before] time and [iff1] state before it
+static void bench_step(MSX* m, STAMP before, int iff1)
+{
+	BENCH* b = &m->bench;
+	Z80* cpu = &m->cpu;
+	STAMP now;
+
+	if (b->state == BENCH_ARMED && b->mode == BENCH_CALL && cpu->pc == b->probe)
+	{
+		b->state = BENCH_RUNNING;
+		b->start = before;
+		b->sp = cpu->sp;
+		b->ret = (uint16_t)(mem_read(m, cpu->sp) | (mem_read(m, (uint16_t)(cpu->sp + 1)) << 8));
+	}
+	if (b->state != BENCH_RUNNING) return;
+
+	now = stamp(m);
+	if (b->mode == BENCH_INT && !b->entered && cpu->pc == b->probe)
+	{
+		b->entry = now;
+		b->entered = 1;
+	}
+
+	if (iff1 && !cpu->iff1)
+	{
+		b->di_start = before;
+		b->di_open = 1;
+	}
+	else if (b->di_open && cpu->iff1)
+	{
+		if (b->mode == BENCH_CALL && !iff1) close_di(m, now);
+		else if (b->mode == BENCH_INT && !cpu->ei_delay) close_di(m, now);
+	}
+
+	if (cpu->pc == b->ret && cpu->sp == (uint16_t)(b->sp + 2))
+	{
+		if (b->di_open && b->mode == BENCH_INT) close_di(m, now);
+		b->end = now;
+		b->state = BENCH_DONE;
+	}
+}
+
+
+
+// MSX-DOS function call (CALL 5)
+static void bdos(MSX* m)
+{
+	Z80* cpu = &m->cpu;
+	uint8_t function = (uint8_t)cpu->bc;
+	uint16_t address;
+
+	switch (function)
+	{
+		case 0x00:
+			m->exit_code = 0;
+			m->finished = 1;
+			return;
+		case 0x02:
+			putchar(cpu->de & 0xFF);
+			break;
+		case 0x09:
+			for (address = cpu->de; mem_read(m, address) != '$'; address++)
+				putchar(mem_read(m, address));
+			break;
+		case 0x62:
+			m->exit_code = cpu->bc >> 8;
+			m->finished = 1;
+			return;
+		default:
+			fprintf(stderr, "msxemu: MSX-DOS function 0x%02X not emulated\n", function);
+			m->exit_code = EXIT_ERROR;
+			m->finished = 1;
+			return;
+	}
+	cpu->af &= 0x00FF;	// A = 0
+	cpu->pc = (uint16_t)(mem_read(m, cpu->sp) | (mem_read(m, (uint16_t)(cpu->sp + 1)) << 8));
+	cpu->sp += 2;
+}
+
+
+
+static int hex_value(const char* text, int digits)
+{
+	int value = 0;
+	while (digits--)
+	{
+		char c = *text++;
+		value <<= 4;
+		if (c >= '0' && c <= '9') value |= c - '0';
+		else if (c >= 'A' && c <= 'F') value |= c - 'A' + 10;
+		else if (c >= 'a' && c <= 'f') value |= c - 'a' + 10;
+		else return -1;
+	}
+	return value;
+}
+
+// Intel HEX generated by SDCC (records 00 and 01)
+static int load_ihx(MSX* m, FILE* file)
+{
+	char line[600];
+	int count, address, type, value, i;
+
+	while (fgets(line, sizeof(line), file))
+	{
+		if (line[0] != ':') continue;
+		count = hex_value(line + 1, 2);
+		address = hex_value(line + 3, 4);
+		type = hex_value(line + 7, 2);
+		if (count < 0 || address < 0 || type < 0) return -1;
+		if (type == 1) return 0;
+		if (type != 0) continue;
+		for (i = 0; i < count; i++)
+		{
+			value = hex_value(line + 9 + i * 2, 2);
+			if (value < 0) return -1;
+			mem_write(m, (uint16_t)(address + i), (uint8_t)value);
+		}
+	}
+	return 0;
+}
+
+static int load_com(MSX* m, FILE* file)
+{
+	int value;
+	uint16_t address = 0x0100;
+	while ((value = fgetc(file)) != EOF)
+	{
+		if (address >= TPA_TOP) return -1;
+		mem_write(m, address++, (uint8_t)value);
+	}
+	return 0;
+}
+
+static int load(MSX* m, const char* filename)
+{
+	const char* extension = strrchr(filename, '.');
+	FILE* file = fopen(filename, "rb");
+	int result;
+
+	if (!file) return -1;
+	if (extension && (!strcmp(extension, ".ihx") || !strcmp(extension, ".hex")))
+		result = load_ihx(m, file);
+	else
+		result = load_com(m, file);
+	fclose(file);
+	return result;
+}
+
+
+
+static void init_msx(MSX* m, int pal, int wait_m1, int r800)
+{
+	int i;
+
+	memset(m, 0, sizeof(*m));
+	m->wait_m1 = wait_m1;
+	m->r800 = r800;
+	m->line_cycles = r800 ? LINE_CYCLES * R800_CLOCK : LINE_CYCLES;
+	m->lines = pal ? PAL_LINES : NTSC_LINES;
+
+	// MSX-DOS: segments 3, 2, 1, 0 in pages 0 to 3
+	for (i = 0; i < 4; i++) m->mapper[i] = (uint8_t)(3 - i);
+
+	m->vdp_reg[1] = 0x20;				// IE0
+	mem_write(m, RG1SAV, 0x20);			// as the BIOS
+	m->next_frame = (uint64_t)m->lines * m->line_cycles;
+	m->line_time = ~(uint64_t)0;
+
+	mem_write(m, 0x0000, 0xC3);			// JP (warm boot, trapped)
+	mem_write(m, BDOS, 0xC3);			// JP (trapped)
+	mem_write(m, 0x0006, TPA_TOP & 0xFF);
+	mem_write(m, 0x0007, TPA_TOP >> 8);
+	mem_write(m, HINT, 0xC3);
+	mem_write(m, HINT + 1, BIOS_ISR & 0xFF);
+	mem_write(m, HINT + 2, BIOS_ISR >> 8);
+	for (i = 0; i < (int)sizeof(bios_isr); i++)
+		mem_write(m, (uint16_t)(BIOS_ISR + i), bios_isr[i]);
+	for (i = HOOKS_START; i < HOOKS_END; i++)
+		mem_write(m, (uint16_t)i, 0xC9);
+
+	z80_reset(&m->cpu);
+	m->cpu.ctx = m;
+	m->cpu.read = mem_read;
+	m->cpu.write = mem_write;
+	m->cpu.in = io_read;
+	m->cpu.out = io_write;
+	m->cpu.im = 1;
+	m->cpu.iff1 = m->cpu.iff2 = 1;
+	m->cpu.sp = TPA_TOP - 2;			// return address: warm boot
+	m->cpu.pc = 0x0100;
+}
+
+
+
+static void usage(void)
+{
+	fprintf(stderr,
+		"usage: msxemu [-p] [-z] [-r] [-f frames] program.ihx|program.com\n"
+		"  -p         PAL (313 lines) instead of NTSC (262 lines)\n"
+		"  -z         Z80 without the M1 wait state of the MSX\n"
+		"  -r         R800 cycles without page breaks (MSX turbo R)\n"
+		"  -f frames  time limit in frames (default 3000)\n");
+}
+
+
+
+int main(int argc, char* argv[])
+{
+	static MSX msx;
+	MSX* m = &msx;
+	int pal = 0, wait_m1 = 1, r800 = 0;
+	long frames = 3000;
+	uint64_t limit;
+	const char* filename = NULL;
+	STAMP before;
+	uint16_t pc;
+	int i, iff1;
+
+	for (i = 1; i < argc; i++)
+	{
+		if (!strcmp(argv[i], "-p")) pal = 1;
+		else if (!strcmp(argv[i], "-z")) wait_m1 = 0;
+		else if (!strcmp(argv[i], "-r")) r800 = 1;
+		else if (!strcmp(argv[i], "-f") && i + 1 < argc) frames = atol(argv[++i]);
+		else if (argv[i][0] != '-' && !filename) filename = argv[i];
+		else
+		{
+			usage();
+			return EXIT_ERROR;
+		}
+	}
+	if (!filename)
+	{
+		usage();
+		return EXIT_ERROR;
+	}
+
+	init_msx(m, pal, wait_m1, r800);
+	if (load(m, filename))
+	{
+		fprintf(stderr, "msxemu: can not load %s\n", filename);
+		return EXIT_ERROR;
+	}
+
+	limit = (uint64_t)frames * m->lines * m->line_cycles;
+
+	while (!m->finished)
+	{
+		update_vdp(m);
+		if (now(m) >= limit)
+		{
+			fprintf(stderr, "msxemu: time limit (%ld frames)\n", frames);
+			m->exit_code = EXIT_TIMEOUT;
+			break;
+		}
+
+		before = stamp(m);
+		pc = m->cpu.pc;
+		if (int_line(m) && z80_interrupt(&m->cpu, 0xFF))
+		{
+			bench_interrupt(m, before, pc);
+			continue;
+		}
+
+		if (!m->cpu.halted && m->cpu.pc < HINT)
+		{
+			if (m->cpu.pc == BDOS)
+			{
+				bdos(m);
+				continue;
+			}
+			fprintf(stderr, "msxemu: call to 0x%04X (BIOS not emulated)\n", m->cpu.pc);
+			m->exit_code = EXIT_ERROR;
+			break;
+		}
+
+		if (m->cpu.halted && !m->cpu.iff1)
+		{
+			fprintf(stderr, "msxemu: HALT with the interrupts disabled at 0x%04X\n",
+				(uint16_t)(m->cpu.pc - 1));
+			m->exit_code = EXIT_ERROR;
+			break;
+		}
+
+		iff1 = m->cpu.iff1;
+		z80_step(&m->cpu);
+		bench_step(m, before, iff1);
+	}
+
+	fflush(stdout);
+	return m->exit_code;
+}
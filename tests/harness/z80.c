@@ -0,0 +1,894 @@
+/* =============================================================================
+Z80 core of the test harness (fR3eL Project)
+Cycle-counting Z80 interpreter. Executes the documented instruction set and
+the undocumented ones generated by SDCC (IXH/IXL/IYH/IYL, SLL, DDCB with
+register copy). The undocumented flag bits 3 and 5 follow the result.
+
+The R800 cycles are counted as one cycle for each byte of the instruction
+(prefixes and operands), for each memory access and for each I/O access, plus
+the internal cycles of PUSH, RST, the taken relative jumps, the (IX+d)
+address, the read-modify-write on memory and EX (SP),HL. Page breaks (+1 when
+an access changes of 256-byte page) and the I/O waits of the turbo R are not
+counted: it is the lower bound.
+https://github.com/mvac7/SDCC_MSX_fR3eL
+============================================================================= */
+
+#include "z80.h"
+
+
+#define FC	Z80_FC
+#define FN	Z80_FN
+#define FPV	Z80_FPV
+#define F3	Z80_F3
+#define FH	Z80_FH
+#define F5	Z80_F5
+#define FZ	Z80_FZ
+#define FS	Z80_FS
+
+#define RD(a)		(cpu->r800++, cpu->read(cpu->ctx, (uint16_t)(a)))
+#define WR(a,v)		(cpu->r800++, cpu->write(cpu->ctx, (uint16_t)(a), (uint8_t)(v)))
+#define IN(p)		(cpu->r800++, cpu->in(cpu->ctx, (uint16_t)(p)))
+#define OUT(p,v)	(cpu->r800++, cpu->out(cpu->ctx, (uint16_t)(p), (uint8_t)(v)))
+
+// Internal cycles of the R800
+#define R800_EXTRA(n)	(cpu->r800 += (n))
+
+#define A		((uint8_t)(cpu->af >> 8))
+#define F		((uint8_t)cpu->af)
+#define SET_A(v)	cpu->af = (uint16_t)((cpu->af & 0x00FF) | ((uint8_t)(v) << 8))
+#define SET_F(v)	cpu->af = (uint16_t)((cpu->af & 0xFF00) | (uint8_t)(v))
+
+
+static uint8_t sz53[256];	// S, Z, bits 5 and 3
+static uint8_t sz53p[256];	// and parity
+static int tables_ready;
+
+
+
+static void init_tables(void)
+{
+	int i, bit, parity;
+	for (i = 0; i < 256; i++)
+	{
+		sz53[i] = (uint8_t)(i & (FS | F5 | F3));
+		if (i == 0) sz53[i] |= FZ;
+		parity = 1;
+		for (bit = 0; bit < 8; bit++) if (i & (1 << bit)) parity ^= 1;
+		sz53p[i] = (uint8_t)(sz53[i] | (parity ? FPV : 0));
+	}
+	tables_ready = 1;
+}
+
+
+
+static uint8_t fetch_m1(Z80* cpu)
+{
+	cpu->m1++;
+	cpu->r = (uint8_t)((cpu->r & 0x80) | ((cpu->r + 1) & 0x7F));
+	return RD(cpu->pc++);
+}
+
+static uint8_t fetch(Z80* cpu)
+{
+	return RD(cpu->pc++);
+}
+
+static uint16_t fetch16(Z80* cpu)
+{
+	uint16_t value = fetch(cpu);
+	return (uint16_t)(value | (fetch(cpu) << 8));
+}
+
+static uint16_t read16(Z80* cpu, uint16_t address)
+{
+	return (uint16_t)(RD(address) | (RD(address + 1) << 8));
+}
+
+static void write16(Z80* cpu, uint16_t address, uint16_t value)
+{
+	WR(address, value & 0xFF);
+	WR(address + 1, value >> 8);
+}
+
+static void push(Z80* cpu, uint16_t value)
+{
+	cpu->sp -= 2;
+	write16(cpu, cpu->sp, value);
+}
+
+static uint16_t pop(Z80* cpu)
+{
+	uint16_t value = read16(cpu, cpu->sp);
+	cpu->sp += 2;
+	return value;
+}
+
+
+
+// ---------------------------------------------------------------- registers
+// xy: 0 = HL, 1 = IX, 2 = IY
+
+static uint16_t* index_reg(Z80* cpu, int xy)
+{
+	return xy == 1 ? &cpu->ix : (xy == 2 ? &cpu->iy : &cpu->hl);
+}
+
+static uint8_t get_reg(Z80* cpu, int r, int xy)
+{
+	switch (r)
+	{
+		case 0: return (uint8_t)(cpu->bc >> 8);
+		case 1: return (uint8_t)cpu->bc;
+		case 2: return (uint8_t)(cpu->de >> 8);
+		case 3: return (uint8_t)cpu->de;
+		case 4: return (uint8_t)(*index_reg(cpu, xy) >> 8);
+		case 5: return (uint8_t)*index_reg(cpu, xy);
+		default: return A;
+	}
+}
+
+static void set_reg(Z80* cpu, int r, int xy, uint8_t v)
+{
+	uint16_t* pair;
+	switch (r)
+	{
+		case 0: cpu->bc = (uint16_t)((cpu->bc & 0x00FF) | (v << 8)); break;
+		case 1: cpu->bc = (uint16_t)((cpu->bc & 0xFF00) | v); break;
+		case 2: cpu->de = (uint16_t)((cpu->de & 0x00FF) | (v << 8)); break;
+		case 3: cpu->de = (uint16_t)((cpu->de & 0xFF00) | v); break;
+		case 4: pair = index_reg(cpu, xy); *pair = (uint16_t)((*pair & 0x00FF) | (v << 8)); break;
+		case 5: pair = index_reg(cpu, xy); *pair = (uint16_t)((*pair & 0xFF00) | v); break;
+		default: SET_A(v); break;
+	}
+}
+
+// rp: BC, DE, HL, SP
+static uint16_t get_rp(Z80* cpu, int p, int xy)
+{
+	switch (p)
+	{
+		case 0: return cpu->bc;
+		case 1: return cpu->de;
+		case 2: return *index_reg(cpu, xy);
+		default: return cpu->sp;
+	}
+}
+
+static void set_rp(Z80* cpu, int p, int xy, uint16_t v)
+{
+	switch (p)
+	{
+		case 0: cpu->bc = v; break;
+		case 1: cpu->de = v; break;
+		case 2: *index_reg(cpu, xy) = v; break;
+		default: cpu->sp = v; break;
+	}
+}
+
+// rp2: BC, DE, HL, AF
+static uint16_t get_rp2(Z80* cpu, int p, int xy)
+{
+	return p == 3 ? cpu->af : get_rp(cpu, p, xy);
+}
+
+static void set_rp2(Z80* cpu, int p, int xy, uint16_t v)
+{
+	if (p == 3) cpu->af = v;
+	else set_rp(cpu, p, xy, v);
+}
+
+static int condition(Z80* cpu, int cc)
+{
+	switch (cc)
+	{
+		case 0: return !(F & FZ);
+		case 1: return F & FZ;
+		case 2: return !(F & FC);
+		case 3: return F & FC;
+		case 4: return !(F & FPV);
+		case 5: return F & FPV;
+		case 6: return !(F & FS);
+		default: return F & FS;
+	}
+}
+
+// Address of the (HL) operand; with IX/IY reads the displacement
+static uint16_t mem_operand(Z80* cpu, int xy)
+{
+	if (xy)
+	{
+		R800_EXTRA(1);
+		return (uint16_t)(*index_reg(cpu, xy) + (int8_t)fetch(cpu));
+	}
+	return cpu->hl;
+}
+
+
+
+// ---------------------------------------------------------------------- ALU
+
+static void alu(Z80* cpu, int op, uint8_t v)
+{
+	uint8_t a = A;
+	unsigned int r;
+	uint8_t carry = F & FC;
+
+	switch (op)
+	{
+		case 0:	// ADD
+			carry = 0;
+			/* fall through */
+		case 1:	// ADC
+			r = a + v + carry;
+			SET_F(sz53[r & 0xFF] | ((a ^ v ^ r) & FH)
+				| (((a ^ ~v) & (a ^ r) & 0x80) ? FPV : 0) | ((r >> 8) & FC));
+			SET_A(r);
+			break;
+		case 2:	// SUB
+		case 7:	// CP
+			carry = 0;
+			/* fall through */
+		case 3:	// SBC
+			r = (unsigned int)(a - v - carry);
+			SET_F(sz53[r & 0xFF] | ((a ^ v ^ r) & FH) | FN
+				| (((a ^ v) & (a ^ r) & 0x80) ? FPV : 0) | ((r >> 8) & FC));
+			if (op == 7) SET_F((F & ~(F3 | F5)) | (v & (F3 | F5)));
+			else SET_A(r);
+			break;
+		case 4:	// AND
+			a &= v;
+			SET_A(a);
+			SET_F(sz53p[a] | FH);
+			break;
+		case 5:	// XOR
+			a ^= v;
+			SET_A(a);
+			SET_F(sz53p[a]);
+			break;
+		default:	// OR
+			a |= v;
+			SET_A(a);
+			SET_F(sz53p[a]);
+			break;
+	}
+}
+
+static uint8_t inc8(Z80* cpu, uint8_t v)
+{
+	uint8_t r = (uint8_t)(v + 1);
+	SET_F((F & FC) | sz53[r] | ((r & 0x0F) ? 0 : FH) | (r == 0x80 ? FPV : 0));
+	return r;
+}
+
+static uint8_t dec8(Z80* cpu, uint8_t v)
+{
+	uint8_t r = (uint8_t)(v - 1);
+	SET_F((F & FC) | FN | sz53[r] | ((v & 0x0F) ? 0 : FH) | (v == 0x80 ? FPV : 0));
+	return r;
+}
+
+static uint16_t add16(Z80* cpu, uint16_t a, uint16_t v)
+{
+	uint32_t r = (uint32_t)a + v;
+	SET_F((F & (FS | FZ | FPV)) | ((r >> 8) & (F3 | F5))
+		| (((a ^ v ^ r) >> 8) & FH) | ((r >> 16) & FC));
+	return (uint16_t)r;
+}
+
+static uint16_t adc16(Z80* cpu, uint16_t a, uint16_t v)
+{
+	uint32_t r = (uint32_t)a + v + (F & FC);
+	SET_F(((r >> 8) & (FS | F3 | F5)) | ((r & 0xFFFF) ? 0 : FZ)
+		| (((a ^ v ^ r) >> 8) & FH)
+		| ((~(a ^ v) & (a ^ r) & 0x8000) ? FPV : 0) | ((r >> 16) & FC));
+	return (uint16_t)r;
+}
+
+static uint16_t sbc16(Z80* cpu, uint16_t a, uint16_t v)
+{
+	uint32_t r = (uint32_t)a - v - (F & FC);
+	SET_F(FN | ((r >> 8) & (FS | F3 | F5)) | ((r & 0xFFFF) ? 0 : FZ)
+		| (((a ^ v ^ r) >> 8) & FH)
+		| (((a ^ v) & (a ^ r) & 0x8000) ? FPV : 0) | ((r >> 16) & FC));
+	return (uint16_t)r;
+}
+
+// RLC RRC RL RR SLA SRA SLL SRL
+static uint8_t rotate(Z80* cpu, int op, uint8_t v)
+{
+	uint8_t r, carry;
+	switch (op)
+	{
+		case 0: carry = v >> 7; r = (uint8_t)((v << 1) | carry); break;
+		case 1: carry = v & 1; r = (uint8_t)((v >> 1) | (carry << 7)); break;
+		case 2: carry = v >> 7; r = (uint8_t)((v << 1) | (F & FC)); break;
+		case 3: carry = v & 1; r = (uint8_t)((v >> 1) | ((F & FC) << 7)); break;
+		case 4: carry = v >> 7; r = (uint8_t)(v << 1); break;
+		case 5: carry = v & 1; r = (uint8_t)((v >> 1) | (v & 0x80)); break;
+		case 6: carry = v >> 7; r = (uint8_t)((v << 1) | 1); break;
+		default: carry = v & 1; r = (uint8_t)(v >> 1); break;
+	}
+	SET_F(sz53p[r] | carry);
+	return r;
+}
+
+static void daa(Z80* cpu)
+{
+	uint8_t a = A, low = a & 0x0F, correction = 0, carry = F & FC, half;
+
+	if ((F & FH) || low > 9) correction |= 0x06;
+	if (carry || a > 0x99) { correction |= 0x60; carry = FC; }
+	if (F & FN)
+	{
+		half = ((F & FH) && low < 6) ? FH : 0;
+		a = (uint8_t)(a - correction);
+	}
+	else
+	{
+		half = low > 9 ? FH : 0;
+		a = (uint8_t)(a + correction);
+	}
+	SET_A(a);
+	SET_F(sz53p[a] | half | (F & FN) | carry);
+}
+
+
+
+// ------------------------------------------------------------ CB prefix
+
+// op on the value; returns 1 if the result must be written back
+static int bit_op(Z80* cpu, uint8_t op, uint8_t* v)
+{
+	int x = op >> 6, y = (op >> 3) & 7;
+	switch (x)
+	{
+		case 0:
+			*v = rotate(cpu, y, *v);
+			return 1;
+		case 1:
+			SET_F((F & FC) | FH | (*v & (F3 | F5))
+				| ((*v & (1 << y)) ? ((y == 7) ? FS : 0) : (FZ | FPV)));
+			return 0;
+		case 2:
+			*v &= (uint8_t)~(1 << y);
+			return 1;
+		default:
+			*v |= (uint8_t)(1 << y);
+			return 1;
+	}
+}
+
+static int exec_cb(Z80* cpu)
+{
+	uint8_t op = fetch_m1(cpu);
+	int z = op & 7;
+	uint8_t v;
+
+	if (z == 6)
+	{
+		v = RD(cpu->hl);
+		if (bit_op(cpu, op, &v))
+		{
+			WR(cpu->hl, v);
+			R800_EXTRA(1);
+			return 15;
+		}
+		return 12;
+	}
+	v = get_reg(cpu, z, 0);
+	if (bit_op(cpu, op, &v)) set_reg(cpu, z, 0, v);
+	return 8;
+}
+
+// DD CB d op / FD CB d op (without the 4 T-states of the prefix)
+static int exec_xycb(Z80* cpu, int xy)
+{
+	uint16_t address = mem_operand(cpu, xy);
+	uint8_t op = fetch(cpu);
+	int z = op & 7;
+	uint8_t v = RD(address);
+
+	if (bit_op(cpu, op, &v))
+	{
+		WR(address, v);
+		R800_EXTRA(1);
+		if (z != 6) set_reg(cpu, z, 0, v);
+		return 19;
+	}
+	return 16;
+}
+
+
+
+// ------------------------------------------------------------ ED prefix
+
+static int exec_block(Z80* cpu, int y, int z)
+{
+	int dir = (y & 1) ? -1 : 1;
+	int repeat = y >= 6;
+	uint8_t v, n;
+
+	switch (z)
+	{
+		case 0:	// LDI LDD LDIR LDDR
+			v = RD(cpu->hl);
+			WR(cpu->de, v);
+			cpu->hl = (uint16_t)(cpu->hl + dir);
+			cpu->de = (uint16_t)(cpu->de + dir);
+			cpu->bc--;
+			n = (uint8_t)(v + A);
+			SET_F((F & (FS | FZ | FC)) | (cpu->bc ? FPV : 0) | (n & F3) | ((n & 0x02) << 4));
+			if (repeat && cpu->bc)
+			{
+				cpu->pc -= 2;
+				return 21;
+			}
+			return 16;
+		case 1:	// CPI CPD CPIR CPDR
+		{
+			uint8_t r, half;
+			v = RD(cpu->hl);
+			r = (uint8_t)(A - v);
+			half = (A ^ v ^ r) & FH;
+			cpu->hl = (uint16_t)(cpu->hl + dir);
+			cpu->bc--;
+			n = (uint8_t)(r - (half ? 1 : 0));
+			SET_F((F & FC) | FN | (sz53[r] & (FS | FZ)) | half
+				| (cpu->bc ? FPV : 0) | (n & F3) | ((n & 0x02) << 4));
+			if (repeat && cpu->bc && r)
+			{
+				cpu->pc -= 2;
+				return 21;
+			}
+			return 16;
+		}
+		case 2:	// INI IND INIR INDR
+			v = IN(cpu->bc);
+			WR(cpu->hl, v);
+			cpu->hl = (uint16_t)(cpu->hl + dir);
+			cpu->bc = (uint16_t)(cpu->bc - 0x100);
+			SET_F((sz53[cpu->bc >> 8] & ~FPV) | FN | (F & FC));
+			if (repeat && (cpu->bc >> 8))
+			{
+				cpu->pc -= 2;
+				return 21;
+			}
+			return 16;
+		default:	// OUTI OUTD OTIR OTDR
+			v = RD(cpu->hl);
+			cpu->bc = (uint16_t)(cpu->bc - 0x100);
+			OUT(cpu->bc, v);
+			cpu->hl = (uint16_t)(cpu->hl + dir);
+			SET_F((sz53[cpu->bc >> 8] & ~FPV) | FN | (F & FC));
+			if (repeat && (cpu->bc >> 8))
+			{
+				cpu->pc -= 2;
+				return 21;
+			}
+			return 16;
+	}
+}
+
+static int exec_ed(Z80* cpu)
+{
+	uint8_t op = fetch_m1(cpu);
+	int x = op >> 6, y = (op >> 3) & 7, z = op & 7, p = y >> 1, q = y & 1;
+	uint8_t v;
+	uint16_t address;
+
+	if (x == 2 && z <= 3 && y >= 4) return exec_block(cpu, y, z);
+	if (x != 1) return 8;
+
+	switch (z)
+	{
+		case 0:	// IN r,(C)
+			v = IN(cpu->bc);
+			if (y != 6) set_reg(cpu, y, 0, v);
+			SET_F((F & FC) | sz53p[v]);
+			return 12;
+		case 1:	// OUT (C),r
+			OUT(cpu->bc, y == 6 ? 0 : get_reg(cpu, y, 0));
+			return 12;
+		case 2:
+			if (q) cpu->hl = adc16(cpu, cpu->hl, get_rp(cpu, p, 0));
+			else cpu->hl = sbc16(cpu, cpu->hl, get_rp(cpu, p, 0));
+			return 15;
+		case 3:
+			address = fetch16(cpu);
+			if (q) set_rp(cpu, p, 0, read16(cpu, address));
+			else write16(cpu, address, get_rp(cpu, p, 0));
+			return 20;
+		case 4:	// NEG
+			v = A;
+			SET_A(0);
+			alu(cpu, 2, v);
+			return 8;
+		case 5:	// RETN / RETI
+			cpu->iff1 = cpu->iff2;
+			cpu->pc = pop(cpu);
+			return 14;
+		case 6:	// IM
+			cpu->im = (uint8_t)((y & 3) < 2 ? 0 : (y & 3) - 1);
+			return 8;
+		default:
+			switch (y)
+			{
+				case 0: cpu->i = A; return 9;
+				case 1: cpu->r = A; return 9;
+				case 2:
+				case 3:	// LD A,I / LD A,R : P/V = IFF2
+					v = y == 2 ? cpu->i : cpu->r;
+					SET_A(v);
+					SET_F((F & FC) | sz53[v] | (cpu->iff2 ? FPV : 0));
+					return 9;
+				case 4:	// RRD
+					v = RD(cpu->hl);
+					WR(cpu->hl, (v >> 4) | (A << 4));
+					SET_A((A & 0xF0) | (v & 0x0F));
+					SET_F((F & FC) | sz53p[A]);
+					return 18;
+				case 5:	// RLD
+					v = RD(cpu->hl);
+					WR(cpu->hl, (v << 4) | (A & 0x0F));
+					SET_A((A & 0xF0) | (v >> 4));
+					SET_F((F & FC) | sz53p[A]);
+					return 18;
+				default:
+					return 8;
+			}
+	}
+}
+
+
+
+// ---------------------------------------------------- unprefixed (and DD/FD)
+// Returns the T-states without the prefix. With IX/IY, an (IX+d) operand
+// costs 8 more T-states than (HL) (5 in LD (IX+d),n).
+
+static int exec_main(Z80* cpu, uint8_t op, int xy)
+{
+	int x = op >> 6, y = (op >> 3) & 7, z = op & 7, p = y >> 1, q = y & 1;
+	uint8_t v;
+	uint16_t address, value;
+
+	switch (x)
+	{
+	case 0:
+		switch (z)
+		{
+		case 0:
+			switch (y)
+			{
+				case 0: return 4;
+				case 1:
+					value = cpu->af; cpu->af = cpu->af2; cpu->af2 = value;
+					return 4;
+				case 2:	// DJNZ
+					v = fetch(cpu);
+					cpu->bc = (uint16_t)(cpu->bc - 0x100);
+					if (cpu->bc >> 8)
+					{
+						cpu->pc = (uint16_t)(cpu->pc + (int8_t)v);
+						R800_EXTRA(1);
+						return 13;
+					}
+					return 8;
+				case 3:	// JR
+					v = fetch(cpu);
+					cpu->pc = (uint16_t)(cpu->pc + (int8_t)v);
+					R800_EXTRA(1);
+					return 12;
+				default:
+					v = fetch(cpu);
+					if (condition(cpu, y - 4))
+					{
+						cpu->pc = (uint16_t)(cpu->pc + (int8_t)v);
+						R800_EXTRA(1);
+						return 12;
+					}
+					return 7;
+			}
+		case 1:
+			if (q)
+			{
+				*index_reg(cpu, xy) = add16(cpu, *index_reg(cpu, xy), get_rp(cpu, p, xy));
+				return 11;
+			}
+			set_rp(cpu, p, xy, fetch16(cpu));
+			return 10;
+		case 2:
+			switch (p)
+			{
+				case 0:
+				case 1:
+					address = p ? cpu->de : cpu->bc;
+					if (q) SET_A(RD(address));
+					else WR(address, A);
+					return 7;
+				case 2:
+					address = fetch16(cpu);
+					if (q) *index_reg(cpu, xy) = read16(cpu, address);
+					else write16(cpu, address, *index_reg(cpu, xy));
+					return 16;
+				default:
+					address = fetch16(cpu);
+					if (q) SET_A(RD(address));
+					else WR(address, A);
+					return 13;
+			}
+		case 3:
+			set_rp(cpu, p, xy, (uint16_t)(get_rp(cpu, p, xy) + (q ? -1 : 1)));
+			return 6;
+		case 4:
+		case 5:
+			if (y == 6)
+			{
+				address = mem_operand(cpu, xy);
+				v = RD(address);
+				WR(address, z == 4 ? inc8(cpu, v) : dec8(cpu, v));
+				R800_EXTRA(1);
+				return xy ? 19 : 11;
+			}
+			v = get_reg(cpu, y, xy);
+			set_reg(cpu, y, xy, z == 4 ? inc8(cpu, v) : dec8(cpu, v));
+			return 4;
+		case 6:
+			if (y == 6)
+			{
+				address = mem_operand(cpu, xy);
+				WR(address, fetch(cpu));
+				return xy ? 15 : 10;
+			}
+			set_reg(cpu, y, xy, fetch(cpu));
+			return 7;
+		default:
+			switch (y)
+			{
+				case 0:	// RLCA
+					v = (uint8_t)((A << 1) | (A >> 7));
+					SET_A(v);
+					SET_F((F & (FS | FZ | FPV)) | (v & (F3 | F5 | FC)));
+					return 4;
+				case 1:	// RRCA
+					v = (uint8_t)((A >> 1) | (A << 7));
+					SET_F((F & (FS | FZ | FPV)) | (v & (F3 | F5)) | (A & FC));
+					SET_A(v);
+					return 4;
+				case 2:	// RLA
+					v = (uint8_t)((A << 1) | (F & FC));
+					SET_F((F & (FS | FZ | FPV)) | (v & (F3 | F5)) | (A >> 7));
+					SET_A(v);
+					return 4;
+				case 3:	// RRA
+					v = (uint8_t)((A >> 1) | ((F & FC) << 7));
+					SET_F((F & (FS | FZ | FPV)) | (v & (F3 | F5)) | (A & FC));
+					SET_A(v);
+					return 4;
+				case 4:
+					daa(cpu);
+					return 4;
+				case 5:	// CPL
+					SET_A(~A);
+					SET_F((F & (FS | FZ | FPV | FC)) | FH | FN | (A & (F3 | F5)));
+					return 4;
+				case 6:	// SCF
+					SET_F((F & (FS | FZ | FPV)) | FC | (A & (F3 | F5)));
+					return 4;
+				default:	// CCF
+					SET_F(((F & (FS | FZ | FPV)) | ((F & FC) ? FH : FC)) | (A & (F3 | F5)));
+					return 4;
+			}
+		}
+
+	case 1:
+		if (op == 0x76)	// HALT
+		{
+			cpu->halted = 1;
+			return 4;
+		}
+		if (y == 6)
+		{
+			address = mem_operand(cpu, xy);
+			WR(address, get_reg(cpu, z, 0));
+			return xy ? 15 : 7;
+		}
+		if (z == 6)
+		{
+			address = mem_operand(cpu, xy);
+			set_reg(cpu, y, 0, RD(address));
+			return xy ? 15 : 7;
+		}
+		set_reg(cpu, y, xy, get_reg(cpu, z, xy));
+		return 4;
+
+	case 2:
+		if (z == 6)
+		{
+			alu(cpu, y, RD(mem_operand(cpu, xy)));
+			return xy ? 15 : 7;
+		}
+		alu(cpu, y, get_reg(cpu, z, xy));
+		return 4;
+
+	default:
+		switch (z)
+		{
+		case 0:	// RET cc
+			if (condition(cpu, y))
+			{
+				cpu->pc = pop(cpu);
+				return 11;
+			}
+			return 5;
+		case 1:
+			if (!q)
+			{
+				set_rp2(cpu, p, xy, pop(cpu));
+				return 10;
+			}
+			switch (p)
+			{
+				case 0:
+					cpu->pc = pop(cpu);
+					return 10;
+				case 1:	// EXX
+					value = cpu->bc; cpu->bc = cpu->bc2; cpu->bc2 = value;
+					value = cpu->de; cpu->de = cpu->de2; cpu->de2 = value;
+					value = cpu->hl; cpu->hl = cpu->hl2; cpu->hl2 = value;
+					return 4;
+				case 2:
+					cpu->pc = *index_reg(cpu, xy);
+					return 4;
+				default:
+					cpu->sp = *index_reg(cpu, xy);
+					return 6;
+			}
+		case 2:
+			address = fetch16(cpu);
+			if (condition(cpu, y)) cpu->pc = address;
+			return 10;
+		case 3:
+			switch (y)
+			{
+				case 0:
+					cpu->pc = fetch16(cpu);
+					return 10;
+				case 2:
+					v = fetch(cpu);
+					OUT((A << 8) | v, A);
+					return 11;
+				case 3:
+					v = fetch(cpu);
+					SET_A(IN((A << 8) | v));
+					return 11;
+				case 4:	// EX (SP),HL
+					value = read16(cpu, cpu->sp);
+					write16(cpu, cpu->sp, *index_reg(cpu, xy));
+					*index_reg(cpu, xy) = value;
+					R800_EXTRA(2);
+					return 19;
+				case 5:	// EX DE,HL
+					value = cpu->de; cpu->de = cpu->hl; cpu->hl = value;
+					return 4;
+				case 6:
+					cpu->iff1 = cpu->iff2 = 0;
+					return 4;
+				case 7:
+					cpu->iff1 = cpu->iff2 = 1;
+					cpu->ei_delay = 1;
+					return 4;
+				default:	// CB, handled by z80_step
+					return 4;
+			}
+		case 4:
+			address = fetch16(cpu);
+			if (condition(cpu, y))
+			{
+				push(cpu, cpu->pc);
+				cpu->pc = address;
+				return 17;
+			}
+			return 10;
+		case 5:
+			if (!q)
+			{
+				push(cpu, get_rp2(cpu, p, xy));
+				R800_EXTRA(1);
+				return 11;
+			}
+			address = fetch16(cpu);	// CALL nn (DD, ED, FD are handled by z80_step)
+			push(cpu, cpu->pc);
+			cpu->pc = address;
+			return 17;
+		case 6:
+			alu(cpu, y, fetch(cpu));
+			return 7;
+		default:	// RST
+			push(cpu, cpu->pc);
+			cpu->pc = (uint16_t)(y * 8);
+			R800_EXTRA(1);
+			return 11;
+		}
+	}
+}
+
+
+
+void z80_reset(Z80* cpu)
+{
+	if (!tables_ready) init_tables();
+	cpu->af = cpu->bc = cpu->de = cpu->hl = 0xFFFF;
+	cpu->af2 = cpu->bc2 = cpu->de2 = cpu->hl2 = 0xFFFF;
+	cpu->ix = cpu->iy = cpu->sp = 0xFFFF;
+	cpu->pc = 0;
+	cpu->i = cpu->r = 0;
+	cpu->iff1 = cpu->iff2 = cpu->im = 0;
+	cpu->halted = 0;
+	cpu->ei_delay = 0;
+	cpu->cycles = 0;
+	cpu->m1 = 0;
+	cpu->r800 = 0;
+}
+
+
+
+int z80_step(Z80* cpu)
+{
+	uint8_t op;
+	int t = 0, xy = 0;
+
+	cpu->ei_delay = 0;
+
+	if (cpu->halted)
+	{
+		// HALT executes NOPs until an interrupt
+		cpu->m1++;
+		cpu->r = (uint8_t)((cpu->r & 0x80) | ((cpu->r + 1) & 0x7F));
+		cpu->cycles += 4;
+		cpu->r800++;
+		return 4;
+	}
+
+	op = fetch_m1(cpu);
+	while (op == 0xDD || op == 0xFD)
+	{
+		xy = op == 0xDD ? 1 : 2;
+		t += 4;
+		op = fetch_m1(cpu);
+	}
+
+	if (op == 0xED) t += exec_ed(cpu);
+	else if (op == 0xCB) t += xy ? exec_xycb(cpu, xy) : exec_cb(cpu);
+	else t += exec_main(cpu, op, xy);
+
+	cpu->cycles += (uint64_t)t;
+	return t;
+}
+
+
+
+int z80_interrupt(Z80* cpu, uint8_t data)
+{
+	int t;
+
+	if (!cpu->iff1 || cpu->ei_delay) return 0;
+
+	cpu->halted = 0;
+	cpu->iff1 = cpu->iff2 = 0;
+	cpu->m1++;
+	cpu->r = (uint8_t)((cpu->r & 0x80) | ((cpu->r + 1) & 0x7F));
+	push(cpu, cpu->pc);
+	R800_EXTRA(1);			// acknowledge
+	if (cpu->im == 2)
+	{
+		cpu->pc = read16(cpu, (uint16_t)((cpu->i << 8) | data));
+		t = 19;
+	}
+	else
+	{
+		cpu->pc = 0x0038;
+		t = 13;
+	}
+	cpu->cycles += (uint64_t)t;
+	return t;
+}
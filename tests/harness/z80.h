@@ -0,0 +1,79 @@
+/* =============================================================================
+Z80 core of the test harness (fR3eL Project)
+Cycle-counting Z80 interpreter used to run the libraries headless on Linux.
+Counts the T-states and the M1 cycles (opcode fetches) of every instruction,
+so the MSX time (one wait state in every M1) is T-states + M1 cycles.
+Also counts the cycles of the R800 (MSX turbo R) without page breaks.
+https://github.com/mvac7/SDCC_MSX_fR3eL
+============================================================================= */
+
+#ifndef  __Z80_H__
+#define  __Z80_H__
+
+#include <stdint.h>
+
+
+#define Z80_FC	0x01
+#define Z80_FN	0x02
+#define Z80_FPV	0x04
+#define Z80_F3	0x08
+#define Z80_FH	0x10
+#define Z80_F5	0x20
+#define Z80_FZ	0x40
+#define Z80_FS	0x80
+
+
+typedef struct Z80 {
+	uint16_t af, bc, de, hl;
+	uint16_t af2, bc2, de2, hl2;	// alternate registers
+	uint16_t ix, iy, sp, pc;
+	uint8_t  i, r;
+	uint8_t  iff1, iff2, im;
+	uint8_t  halted;
+	uint8_t  ei_delay;				// 1 = the last instruction was EI
+
+	uint64_t cycles;				// T-states
+	uint64_t m1;					// M1 cycles
+	uint64_t r800;					// R800 cycles, without page breaks
+
+	void*    ctx;
+	uint8_t  (*read)(void* ctx, uint16_t address);
+	void     (*write)(void* ctx, uint16_t address, uint8_t value);
+	uint8_t  (*in)(void* ctx, uint16_t port);
+	void     (*out)(void* ctx, uint16_t port, uint8_t value);
+} Z80;
+
+
+/* =============================================================================
+ z80_reset
+
+ Function : Reset the CPU (PC=0, IM 0, interrupts disabled) and the counters
+ Input    : [cpu] CPU
+============================================================================= */
+void z80_reset(Z80* cpu);
+
+
+/* =============================================================================
+ z80_step
+
+ Function : Execute one instruction (or one HALT cycle)
+ Input    : [cpu] CPU
+ Output   : T-states of the instruction
+============================================================================= */
+int z80_step(Z80* cpu);
+
+
+/* =============================================================================
+ z80_interrupt
+
+ Function : Accept a maskable interrupt if IFF1 is set and the previous
+            instruction was not EI. Only IM 1 and IM 2 are supported
+            (IM 0 executes RST 38h, as on MSX).
+ Input    : [cpu]  CPU
+            [data] byte on the data bus (IM 2 vector low byte)
+ Output   : T-states of the acknowledge; 0 if not accepted
+============================================================================= */
+int z80_interrupt(Z80* cpu, uint8_t data);
+
+
+#endif
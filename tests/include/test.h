@@ -0,0 +1,160 @@
+/* =============================================================================
+Test functions for the harness (fR3eL Project)
+Output, checks and control of the devices of the MSX test harness (msxemu).
+https://github.com/mvac7/SDCC_MSX_fR3eL
+============================================================================= */
+
+#ifndef  __TEST_H__
+#define  __TEST_H__
+
+
+// Ports of the harness
+#define TEST_PORT_DEVICE	0x2B	// device interrupt (KEYI)
+#define TEST_PORT_PROBE		0x2C	// address of the probe (benchmark)
+#define TEST_PORT_BENCH		0x2D	// benchmark command
+#define TEST_PORT_PUTCHAR	0x2E	// character output
+#define TEST_PORT_EXIT		0x2F	// end of the program
+
+// Commands of Test_Bench
+#define TEST_BENCH_CALL		1	// measure the next call to the probe
+#define TEST_BENCH_INT		2	// measure the next interrupt
+#define TEST_BENCH_TOTAL	3	// print the total of the last measure
+#define TEST_BENCH_DI		4	// print the longest DI window of the last measure
+#define TEST_BENCH_ENTRY	5	// print the time from the interrupt to the probe
+
+// Result of Test_Registers
+#define TEST_MAINREGS		0x01	// BC, DE, HL and A kept
+#define TEST_INDEXREGS		0x02	// IX and IY kept
+#define TEST_ALTREGS		0x04	// AF', BC', DE' and HL' kept
+#define TEST_ALLREGS		0x07
+
+#define PEEK(address)		(*(volatile char*)(address))
+#define PEEKW(address)		(*(volatile unsigned int*)(address))
+
+
+
+/* =============================================================================
+ Test_Print
+
+ Function : Print a text (harness output)
+ Input    : [text] text ended by 0
+ Output   : -
+============================================================================= */
+void Test_Print(char* text);
+
+
+
+/* =============================================================================
+ Test_PrintNumber
+
+ Function : Print a number in decimal
+ Input    : [value] number
+ Output   : -
+============================================================================= */
+void Test_PrintNumber(unsigned int value);
+
+
+
+/* =============================================================================
+ Test_Check
+
+ Function : Count a test and print its result
+ Input    : [name] name of the test
+            [ok] 0 = failed
+ Output   : -
+============================================================================= */
+void Test_Check(char* name, char ok);
+
+
+
+/* =============================================================================
+ Test_End
+
+ Function : Print the summary of the tests
+ Input    : -
+ Output   : number of failed tests (exit code of the program)
+============================================================================= */
+char Test_End(void);
+
+
+
+/* =============================================================================
+ Test_Frames
+
+ Function : Enable the interrupts and wait for N interrupts (HALT)
+ Input    : [frames] number of interrupts
+ Output   : -
+============================================================================= */
+void Test_Frames(char frames);
+
+
+
+/* =============================================================================
+ Test_IFF
+
+ Function : Returns the state of the interrupts
+ Input    : -
+ Output   : 1 = enabled; 0 = disabled
+============================================================================= */
+char Test_IFF(void);
+
+
+
+/* =============================================================================
+ Test_Registers
+
+ Function : Load known values in all the registers, wait for two interrupts
+            and check that the values are kept
+ Input    : -
+ Output   : TEST_MAINREGS | TEST_INDEXREGS | TEST_ALTREGS of the kept registers
+============================================================================= */
+char Test_Registers(void);
+
+
+
+/* =============================================================================
+ Test_Device
+
+ Function : Raise or release the interrupt of the test device (KEYI)
+ Input    : [state] 1 = raise; 0 = release
+ Output   : -
+============================================================================= */
+void Test_Device(char state);
+
+
+
+/* =============================================================================
+ Test_DeviceAck
+
+ Function : Acknowledge the interrupt of the test device (from KEYI)
+ Input    : -
+ Output   : 1 = the device was interrupting
+============================================================================= */
+char Test_DeviceAck(void);
+
+
+
+/* =============================================================================
+ Test_Probe
+
+ Function : Set the address of the probe of the benchmark
+ Input    : [address] function measured, or reached from the interrupt
+ Output   : -
+============================================================================= */
+void Test_Probe(unsigned int address);
+
+
+
+/* =============================================================================
+ Test_Bench
+
+ Function : Send a command to the benchmark of the harness
+ Input    : [command] TEST_BENCH_CALL, TEST_BENCH_INT, TEST_BENCH_TOTAL,
+                      TEST_BENCH_DI or TEST_BENCH_ENTRY
+ Output   : -
+============================================================================= */
+void Test_Bench(char command);
+
+
+
+#endif
@@ -0,0 +1,71 @@
+#!/bin/sh
+# Build and run the tests of the libraries on the MSX test harness (msxemu)
+# on Linux/macOS. Requires SDCC and a C compiler (cc).
+# The exit code is the number of test programs that failed.
+# "make.sh bench" runs the benchmark instead and writes build/bench.md
+# (Z80 and MSX) and build/bench_r800.md (R800)
+set -e
+cd "$(dirname "$0")"
+mkdir -p build
+echo Compiling harness
+${CC:-cc} -O2 -o build/msxemu harness/z80.c harness/msx.c
+echo Building libraries
+sh ../ISR/sources/make.sh
+sh ../Hooks/sources/make.sh
+
+ISR=../ISR/sources/build
+HOOKS=../Hooks/sources/build
+CRT0=../ISR/examples/test01_isr/libs/crt0_MSXDOS.rel
+COM="sdcc -mz80 -o build/ --code-loc 0x0108 --data-loc 0 --use-stdout --no-std-crt0 $CRT0 build/test.rel"
+
+sdcc -mz80 -c -o build/ src/test.c
+
+if [ "$1" = "bench" ]
+then
+  echo Compiling benchmark
+  $COM $ISR/interruptM1_ISR.rel \
+    $ISR/ISR_Basic_NoAlt.rel $ISR/ISR_TIMI.rel $ISR/ISR_TIMI_NoAlt.rel \
+    $ISR/ISR_KEYI.rel $ISR/ISR_NoHooks.rel $ISR/ISR_Line.rel $ISR/ISR_DOS2.rel \
+    $ISR/ISR_Stack.rel $ISR/ISR_Shadow.rel $ISR/ISR_Nested.rel \
+    $ISR/interruptM1_ISRreloc.rel \
+    $ISR/interruptM1_LineInt.rel $ISR/interruptM1_Stack.rel \
+    $ISR/interruptM1_Dispatch.rel \
+    $HOOKS/interruptM1_Hooks.rel $HOOKS/interruptM1_HookChain.rel \
+    $HOOKS/interruptM1_Subscribers.rel \
+    src/bench.c
+  echo Running benchmark
+  build/msxemu build/bench.ihx > build/bench.md
+  cat build/bench.md
+  build/msxemu -r build/bench.ihx > build/bench_r800.md
+  cat build/bench_r800.md
+  exit 0
+fi
+
+echo Compiling tests
+$COM $ISR/interruptM1_ISR.rel \
+  $ISR/ISR_Basic_NoAlt.rel $ISR/ISR_TIMI.rel $ISR/ISR_TIMI_NoAlt.rel \
+  $ISR/ISR_KEYI.rel $ISR/ISR_NoHooks.rel $ISR/ISR_Line.rel $ISR/ISR_DOS2.rel \
+  $ISR/ISR_Stack.rel $ISR/ISR_Shadow.rel $ISR/ISR_Nested.rel \
+  $ISR/interruptM1_ISRauto.rel $ISR/interruptM1_ISRreloc.rel \
+  $ISR/interruptM1_LineInt.rel $ISR/interruptM1_Stack.rel \
+  $ISR/interruptM1_Deferred.rel $HOOKS/interruptM1_Hooks.rel \
+  src/test_isr.c
+$COM $HOOKS/interruptM1_Hooks.rel $HOOKS/interruptM1_HookRegistry.rel \
+  $HOOKS/interruptM1_HookChain.rel $HOOKS/interruptM1_Subscribers.rel \
+  src/test_hooks.c
+$COM $ISR/interruptM1_ISR.rel $ISR/ISR_DOS2.rel $ISR/interruptM1_Dispatch.rel \
+  $HOOKS/interruptM1_Hooks.rel \
+  src/test_dispatch.c
+
+# the results of each program are also kept in build/<program>.log, with the
+# version of SDCC in build/sdcc.log, to record the run
+sdcc -v > build/sdcc.log 2>&1
+failed=0
+for test in test_isr test_hooks test_dispatch
+do
+  echo Running $test
+  build/msxemu build/$test.ihx > build/$test.log || failed=$((failed+1))
+  cat build/$test.log
+done
+echo "$failed test programs failed"
+exit $failed
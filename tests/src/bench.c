@@ -0,0 +1,458 @@
+/* =============================================================================
+Benchmark of the interruptM1 Libraries (harness)
+Version: 1.1 (17/10/2026)
+Architecture: MSX (msxemu test harness)
+Format: COM (MSX-DOS)
+Programming language: C and Assembler
+Compiler: SDCC 4.4 or newer
+
+Description:
+Measures with the harness the cost of the ISRs (entry to the TIMI and KEYI
+functions and total of the VBLANK), of the functions of the libraries (total
+and DI window) and of the generated dispatcher. Prints the tables in the
+format of TIMINGS.md, in Z80 T-states and, in brackets, with the M1 wait
+state of the MSX, or in R800 cycles when the harness runs with -r.
+The conditions are the ones of TIMINGS.md: the total of the ISRs with the
+hooks not used (RET), and the subscribers with another one in the list.
+
+History of versions:
+- v1.1 (17/10/2026) Same conditions as TIMINGS.md (RET in the hooks, list of subscribers not empty)
+- v1.0 (17/10/2026) First version
+============================================================================= */
+
+#include "../include/test.h"
+
+#include "../../ISR/sources/include/interruptM1_ISR.h"
+#include "../../ISR/sources/include/interruptM1_Dispatch.h"
+#include "../../ISR/sources/include/interruptM1_LineInt.h"
+#include "../../ISR/sources/include/interruptM1_Wrapper.h"
+#include "../../Hooks/sources/include/interruptM1_Hooks.h"
+#include "../../Hooks/sources/include/interruptM1_Subscribers.h"
+
+
+
+// ----------------------------------------------------------------- definitions
+#define RELOC_ADDRESS	0xD000	// page 3, under the stack of MSX-DOS
+
+typedef struct {
+	ISR_FUNC isr;
+	char* name;
+} ISR_ROW;
+
+
+
+// ---------------------------------------------------- Declaration of functions
+void Bench_TIMI(void);
+void Bench_KEYI(void);
+void Bench_Status(char status);
+void Bench_Hook(void);
+
+void Measure_Call(unsigned int func);
+void Measure_Int(unsigned int func);
+void Print_Cell(char command);
+void Print_Call(char* name);
+void Print_ISR(char* name);
+void Print_Total(void);
+
+void Bench_ISRs(void);
+void Bench_Wrappers(void);
+void Bench_ISRFunctions(void);
+void Bench_HookFunctions(void);
+void Bench_Dispatcher(void);
+
+
+
+// ------------------------------------------------------------------- constants
+ISR_ROW isrs[] = {
+	{ISR_Basic,       "`ISR_Basic`"},
+	{ISR_DOS2,        "`ISR_DOS2`"},
+	{ISR_Stack,       "`ISR_Stack`"},
+	{ISR_Shadow,      "`ISR_Shadow`"},
+	{ISR_Nested,      "`ISR_Nested`"},
+	{ISR_Basic_NoAlt, "`ISR_Basic_NoAlt`"},
+	{ISR_TIMI,        "`ISR_TIMI`"},
+	{ISR_TIMI_NoAlt,  "`ISR_TIMI_NoAlt`"},
+	{ISR_KEYI,        "`ISR_KEYI`"},
+	{ISR_Line,        "`ISR_Line` (IE1 off)"},
+	{ISR_NoHooks,     "`ISR_NoHooks`"}
+};
+
+#define ISRS	(sizeof(isrs) / sizeof(ISR_ROW))
+
+
+
+// ------------------------------------------------------------ global variables
+char slot[HOOK_SIZE];
+char chain[HOOK_CHAIN_SIZE];
+char subs[TIMI_SUBS_SIZE];
+char dispatch_code[2 * DISPATCH_CODE_SIZE];
+TIMI_SUBSCRIBER node;
+TIMI_SUBSCRIBER node_first;		// already in the list
+
+
+
+// ------------------------------------------------------------------- Functions
+
+
+//
+char main(void)
+{
+	Save_ISR();
+	Init_LineInt();
+	Init_ISR_Nested();
+
+	Bench_ISRs();
+	Bench_Wrappers();
+	Bench_ISRFunctions();
+	Bench_HookFunctions();
+	Bench_Dispatcher();
+
+	// the hooks of the harness contain RET
+	DisableI;
+	Restore_ISR();
+	Disable_TIMI();
+	Disable_KEYI();
+	EnableI;
+
+	return 0;
+}
+
+
+
+// ----------------------------------------------------------------- Handlers
+// Only the RET: the measures do not include the cost of your functions
+
+void Bench_TIMI(void) __naked
+{
+__asm
+  ret
+__endasm;
+}
+
+
+
+void Bench_KEYI(void) __naked
+{
+__asm
+  ret
+__endasm;
+}
+
+
+
+void Bench_Status(char status) __naked
+{
+status;	//A
+__asm
+  ret
+__endasm;
+}
+
+ISR_C_HANDLER(ISR_Bench, Bench_Status)
+
+HOOK_C_HANDLER(Bench_Hook, Bench_TIMI)
+
+
+
+// ------------------------------------------------------------------ Measures
+
+// Arms the measure of the next call to func, just after an interrupt
+void Measure_Call(unsigned int func)
+{
+	Test_Frames(1);
+	Test_Probe(func);
+	Test_Bench(TEST_BENCH_CALL);
+}
+
+
+
+// Measures the next VBLANK; func is the function reached from the ISR
+void Measure_Int(unsigned int func)
+{
+	Test_Frames(1);
+	Test_Probe(func);
+	Test_Bench(TEST_BENCH_INT);
+	Test_Frames(1);
+}
+
+
+
+void Print_Cell(char command)
+{
+	Test_Print(" | ");
+	Test_Bench(command);
+}
+
+
+
+// Row of a function: Total | DI window
+void Print_Call(char* name)
+{
+	Test_Print(name);
+	Print_Cell(TEST_BENCH_TOTAL);
+	Print_Cell(TEST_BENCH_DI);
+	Test_Print("\n");
+}
+
+
+
+// Row of an ISR: Entry to TIMI function | Entry to KEYI function | Total
+void Print_ISR(char* name)
+{
+	Test_Print(name);
+	Measure_Int((unsigned int)Bench_TIMI);
+	Print_Cell(TEST_BENCH_ENTRY);
+	Measure_Int((unsigned int)Bench_KEYI);
+	Print_Cell(TEST_BENCH_ENTRY);
+	Print_Total();
+	Test_Print("\n");
+}
+
+
+
+// Total of the VBLANK with the hooks not used: the JP of the hooks paused (RET)
+void Print_Total(void)
+{
+	Pause_TIMI();
+	Pause_KEYI();
+	Measure_Int((unsigned int)Bench_TIMI);
+	Print_Cell(TEST_BENCH_TOTAL);
+	Resume_TIMI();
+	Resume_KEYI();
+}
+
+
+
+// -------------------------------------------------------------------- Tables
+
+void Bench_ISRs(void)
+{
+	char i;
+
+	Test_Print("## ISRs\n\n");
+	Test_Print("ISR | Entry to TIMI function | Entry to KEYI function | Total VBLANK (DI window)\n");
+	Test_Print("--- | --- | --- | ---\n");
+
+	Install_TIMI(Bench_TIMI);
+	Install_KEYI(Bench_KEYI);
+	for (i = 0; i < ISRS; i++)
+	{
+		Install_ISR(isrs[i].isr);
+		Print_ISR(isrs[i].name);
+	}
+
+	Install_ISR_Reloc((char*)RELOC_ADDRESS);
+	Print_ISR("`ISR_Reloc`");
+	Install_TIMI_Direct(Bench_TIMI);
+	Install_KEYI_Direct(Bench_KEYI);
+	Print_ISR("`ISR_Reloc` with `Install_TIMI_Direct`/`Install_KEYI_Direct`");
+	Reset_ISR_Direct();
+
+	Disable_ISR();
+	Print_ISR("`ISR_empty`");
+
+	Restore_ISR();
+	Test_Print("\n");
+}
+
+
+
+void Bench_Wrappers(void)
+{
+	Test_Print("Wrapper | Entry to your function | Total\n");
+	Test_Print("--- | --- | ---\n");
+
+	Install_ISR(ISR_Bench);
+	Test_Print("`ISR_C_HANDLER`");
+	Measure_Int((unsigned int)Bench_Status);
+	Print_Cell(TEST_BENCH_ENTRY);
+	Print_Cell(TEST_BENCH_TOTAL);
+	Test_Print("\n");
+
+	// HOOK_C_HANDLER alone: the ISR and the CALL to the hook are subtracted
+	// by comparing with the row of ISR_Basic (KEYI hook not used)
+	Install_ISR(ISR_Basic);
+	Install_TIMI(Bench_Hook);
+	Pause_KEYI();
+	Test_Print("`ISR_Basic` + `HOOK_C_HANDLER`");
+	Measure_Int((unsigned int)Bench_TIMI);
+	Print_Cell(TEST_BENCH_ENTRY);
+	Print_Cell(TEST_BENCH_TOTAL);
+	Test_Print("\n");
+	Resume_KEYI();
+	Install_TIMI(Bench_TIMI);
+
+	Restore_ISR();
+	Test_Print("\n");
+}
+
+
+
+void Bench_ISRFunctions(void)
+{
+	Test_Print("## Functions of interruptM1_ISR\n\n");
+	Test_Print("Function | Total | DI window\n");
+	Test_Print("--- | --- | ---\n");
+
+	Measure_Call((unsigned int)Save_ISR);
+	Save_ISR();
+	Print_Call("`Save_ISR`");
+
+	Measure_Call((unsigned int)Install_ISR);
+	Install_ISR(ISR_Basic);
+	Print_Call("`Install_ISR`");
+
+	Measure_Call((unsigned int)Restore_ISR);
+	Restore_ISR();
+	Print_Call("`Restore_ISR`");
+
+	Measure_Call((unsigned int)EnterCritical);
+	EnterCritical();
+	Print_Call("`EnterCritical` (outer)");
+
+	Test_Probe((unsigned int)ExitCritical);
+	Test_Bench(TEST_BENCH_CALL);
+	ExitCritical();
+	Print_Call("`ExitCritical` (outer, enables the interrupts)");
+
+	Measure_Call((unsigned int)Install_ISR_Reloc);
+	Install_ISR_Reloc((char*)RELOC_ADDRESS);
+	Print_Call("`Install_ISR_Reloc`");
+
+	Measure_Call((unsigned int)Install_TIMI_Direct);
+	Install_TIMI_Direct(Bench_TIMI);
+	Print_Call("`Install_TIMI_Direct`");
+
+	Reset_ISR_Direct();
+	Restore_ISR();
+	Test_Print("\n");
+}
+
+
+
+void Bench_HookFunctions(void)
+{
+	Test_Print("## Functions of interruptM1_Hooks\n\n");
+	Test_Print("Function | Total | DI window\n");
+	Test_Print("--- | --- | ---\n");
+
+	Measure_Call((unsigned int)Save_TIMI);
+	Save_TIMI();
+	Print_Call("`Save_TIMI`");
+
+	Measure_Call((unsigned int)Install_TIMI);
+	Install_TIMI(Bench_TIMI);
+	Print_Call("`Install_TIMI`");
+
+	Measure_Call((unsigned int)Pause_TIMI);
+	Pause_TIMI();
+	Print_Call("`Pause_TIMI`");
+
+	Measure_Call((unsigned int)Resume_TIMI);
+	Resume_TIMI();
+	Print_Call("`Resume_TIMI`");
+
+	Measure_Call((unsigned int)Disable_TIMI);
+	Disable_TIMI();
+	Print_Call("`Disable_TIMI`");
+
+	Measure_Call((unsigned int)Restore_TIMI);
+	Restore_TIMI();
+	Print_Call("`Restore_TIMI`");
+
+	Measure_Call((unsigned int)Save_Hook);
+	Save_Hook(HOOK_CHPU, slot);
+	Print_Call("`Save_Hook`");
+
+	Measure_Call((unsigned int)Install_Hook);
+	Install_Hook(HOOK_CHPU, Bench_TIMI);
+	Print_Call("`Install_Hook`");
+
+	Measure_Call((unsigned int)Pause_Hook);
+	Pause_Hook(HOOK_CHPU);
+	Print_Call("`Pause_Hook`");
+
+	Measure_Call((unsigned int)Resume_Hook);
+	Resume_Hook(HOOK_CHPU);
+	Print_Call("`Resume_Hook`");
+
+	Measure_Call((unsigned int)Disable_Hook);
+	Disable_Hook(HOOK_CHPU);
+	Print_Call("`Disable_Hook`");
+
+	Measure_Call((unsigned int)Restore_Hook);
+	Restore_Hook(HOOK_CHPU, slot);
+	Print_Call("`Restore_Hook`");
+
+	Save_TIMI();
+	Measure_Call((unsigned int)Install_TIMI_Chained);
+	Install_TIMI_Chained(Bench_TIMI, chain);
+	Print_Call("`Install_TIMI_Chained`");
+	Restore_TIMI();
+
+	Init_Subscribers(subs);
+	Install_Subscribers();
+	Subscribe_TIMI(&node_first, Bench_TIMI);
+	Measure_Call((unsigned int)Subscribe_TIMI);
+	Subscribe_TIMI(&node, Bench_TIMI);
+	Print_Call("`Subscribe_TIMI`");
+
+	Measure_Call((unsigned int)Pause_Subscriber);
+	Pause_Subscriber(&node);
+	Print_Call("`Pause_Subscriber`");
+
+	Measure_Call((unsigned int)Resume_Subscriber);
+	Resume_Subscriber(&node);
+	Print_Call("`Resume_Subscriber`");
+
+	Measure_Call((unsigned int)Unsubscribe_TIMI);
+	Unsubscribe_TIMI(&node);
+	Print_Call("`Unsubscribe_TIMI`");
+	Unsubscribe_TIMI(&node_first);
+	Restore_Subscribers();
+
+	Test_Print("\n");
+}
+
+
+
+void Bench_Dispatcher(void)
+{
+	Test_Print("## VBLANK Dispatcher\n\n");
+	Test_Print("Generated code | Entry to the first handler | Total VBLANK\n");
+	Test_Print("--- | --- | ---\n");
+
+	Disable_KEYI();
+	Init_Dispatcher(dispatch_code);
+	Add_Handler(Bench_TIMI, 0);
+	Install_Dispatcher();
+	Install_ISR(ISR_Basic);
+	Test_Print("`ISR_Basic` + `Install_Dispatcher`, 1 handler");
+	Measure_Int((unsigned int)Bench_TIMI);
+	Print_Cell(TEST_BENCH_ENTRY);
+	Print_Cell(TEST_BENCH_TOTAL);
+	Test_Print("\n");
+
+	Install_DispatcherISR(0);
+	Test_Print("`Install_DispatcherISR(0)`, 1 handler");
+	Measure_Int((unsigned int)Bench_TIMI);
+	Print_Cell(TEST_BENCH_ENTRY);
+	Print_Cell(TEST_BENCH_TOTAL);
+	Test_Print("\n");
+
+	Add_Handler(Bench_KEYI, 1);
+	Test_Print("`Install_DispatcherISR(0)`, 2 handlers");
+	Measure_Int((unsigned int)Bench_KEYI);
+	Print_Cell(TEST_BENCH_ENTRY);
+	Print_Cell(TEST_BENCH_TOTAL);
+	Test_Print("\n");
+
+	Install_DispatcherISR(DISPATCH_ISR_KEYI | DISPATCH_ISR_ALTREGS | DISPATCH_ISR_INDEXREGS);
+	Test_Print("`Install_DispatcherISR` (all the options), 2 handlers");
+	Measure_Int((unsigned int)Bench_KEYI);
+	Print_Cell(TEST_BENCH_ENTRY);
+	Print_Cell(TEST_BENCH_TOTAL);
+	Test_Print("\n");
+
+	Restore_ISR();
+}
@@ -0,0 +1,341 @@
+/* =============================================================================
+Test functions for the harness (fR3eL Project)
+Version: 1.0 (17/10/2026)
+Architecture: MSX (msxemu test harness)
+Format: C Object (SDCC .rel)
+Programming language: C and Z80 assembler
+Compiler: SDCC 4.4 or newer
+
+Description:
+Output, checks and control of the devices of the MSX test harness (msxemu).
+============================================================================= */
+
+#include "../include/test.h"
+
+
+char TEST_count;	// tests executed
+char TEST_failed;	// tests failed
+char TEST_regs;		// result of Test_Registers
+
+
+
+/* =============================================================================
+ Test_PutChar
+
+ Function : Print a character
+ Input    : [c] character
+ Output   : -
+============================================================================= */
+void Test_PutChar(char c) __naked
+{
+c;	//A
+__asm
+  out  (TEST_PORT_PUTCHAR),A
+  ret
+__endasm;
+}
+
+
+
+/* =============================================================================
+ Test_Print
+
+ Function : Print a text (harness output)
+ Input    : [text] text ended by 0
+ Output   : -
+============================================================================= */
+void Test_Print(char* text)
+{
+	while (*text) Test_PutChar(*text++);
+}
+
+
+
+/* =============================================================================
+ Test_PrintNumber
+
+ Function : Print a number in decimal
+ Input    : [value] number
+ Output   : -
+============================================================================= */
+void Test_PrintNumber(unsigned int value)
+{
+	char digits[6];
+	char i = 0;
+
+	do
+	{
+		digits[i++] = '0' + (value % 10);
+		value /= 10;
+	} while (value);
+
+	while (i) Test_PutChar(digits[--i]);
+}
+
+
+
+/* =============================================================================
+ Test_Check
+
+ Function : Count a test and print its result
+ Input    : [name] name of the test
+            [ok] 0 = failed
+ Output   : -
+============================================================================= */
+void Test_Check(char* name, char ok)
+{
+	TEST_count++;
+	if (ok) Test_Print("ok    ");
+	else
+	{
+		TEST_failed++;
+		Test_Print("FAIL  ");
+	}
+	Test_Print(name);
+	Test_PutChar('\n');
+}
+
+
+
+/* =============================================================================
+ Test_End
+
+ Function : Print the summary of the tests
+ Input    : -
+ Output   : number of failed tests (exit code of the program)
+============================================================================= */
+char Test_End(void)
+{
+	Test_PrintNumber(TEST_count);
+	Test_Print(" tests, ");
+	Test_PrintNumber(TEST_failed);
+	Test_Print(" failed\n");
+	return TEST_failed;
+}
+
+
+
+/* =============================================================================
+ Test_Frames
+
+ Function : Enable the interrupts and wait for N interrupts (HALT)
+ Input    : [frames] number of interrupts
+ Output   : -
+============================================================================= */
+void Test_Frames(char frames)
+{
+	while (frames--)
+	{
+	__asm
+	  ei
+	  halt
+	__endasm;
+	}
+}
+
+
+
+/* =============================================================================
+ Test_IFF
+
+ Function : Returns the state of the interrupts
+ Input    : -
+ Output   : 1 = enabled; 0 = disabled
+============================================================================= */
+char Test_IFF(void) __naked
+{
+__asm
+  ld   A,I           ;P/V = IFF2
+  ld   A,#0
+  ret  PO
+  inc  A
+  ret
+__endasm;
+}
+
+
+
+/* =============================================================================
+ Test_Registers
+
+ Function : Load known values in all the registers, wait for two interrupts
+            and check that the values are kept
+ Input    : -
+ Output   : TEST_MAINREGS | TEST_INDEXREGS | TEST_ALTREGS of the kept registers
+============================================================================= */
+char Test_Registers(void) __naked
+{
+__asm
+  push IX
+
+  ld   A,#0x77
+  ex   AF,AF
+  exx
+  ld   BC,#0x1122
+  ld   DE,#0x3344
+  ld   HL,#0x5566
+  exx
+  ld   BC,#0x99AA
+  ld   DE,#0xBBCC
+  ld   HL,#0xDDEE
+  ld   IX,#0x1357
+  ld   IY,#0x2468
+  ld   A,#0x88
+
+  ei
+  halt
+  halt
+
+; main registers
+  cp   #0x88
+  jr   NZ,1$
+  ld   A,B
+  cp   #0x99
+  jr   NZ,1$
+  ld   A,C
+  cp   #0xAA
+  jr   NZ,1$
+  ld   A,D
+  cp   #0xBB
+  jr   NZ,1$
+  ld   A,E
+  cp   #0xCC
+  jr   NZ,1$
+  ld   A,H
+  cp   #0xDD
+  jr   NZ,1$
+  ld   A,L
+  cp   #0xEE
+  jr   NZ,1$
+  ld   A,#TEST_MAINREGS
+  jr   2$
+1$:
+  xor  A
+2$:
+  ld   (#_TEST_regs),A
+
+; index registers
+  push IX
+  pop  HL
+  ld   DE,#0x1357
+  or   A
+  sbc  HL,DE
+  jr   NZ,3$
+  push IY
+  pop  HL
+  ld   DE,#0x2468
+  or   A
+  sbc  HL,DE
+  jr   NZ,3$
+  ld   HL,#_TEST_regs
+  set  1,(HL)
+3$:
+
+; alternate registers
+  exx
+  ld   A,B
+  cp   #0x11
+  jr   NZ,4$
+  ld   A,C
+  cp   #0x22
+  jr   NZ,4$
+  ld   A,D
+  cp   #0x33
+  jr   NZ,4$
+  ld   A,E
+  cp   #0x44
+  jr   NZ,4$
+  ld   A,H
+  cp   #0x55
+  jr   NZ,4$
+  ld   A,L
+  cp   #0x66
+  jr   NZ,4$
+  ex   AF,AF
+  cp   #0x77
+  jr   NZ,4$
+  ld   HL,#_TEST_regs
+  set  2,(HL)
+4$:
+  exx
+
+  ld   A,(#_TEST_regs)
+  pop  IX
+  ret
+__endasm;
+}
+
+
+
+/* =============================================================================
+ Test_Device
+
+ Function : Raise or release the interrupt of the test device (KEYI)
+ Input    : [state] 1 = raise; 0 = release
+ Output   : -
+============================================================================= */
+void Test_Device(char state) __naked
+{
+state;	//A
+__asm
+  out  (TEST_PORT_DEVICE),A
+  ret
+__endasm;
+}
+
+
+
+/* =============================================================================
+ Test_DeviceAck
+
+ Function : Acknowledge the interrupt of the test device (from KEYI)
+ Input    : -
+ Output   : 1 = the device was interrupting
+============================================================================= */
+char Test_DeviceAck(void) __naked
+{
+__asm
+  in   A,(TEST_PORT_DEVICE)
+  ret
+__endasm;
+}
+
+
+
+/* =============================================================================
+ Test_Probe
+
+ Function : Set the address of the probe of the benchmark
+ Input    : [address] function measured, or reached from the interrupt
+ Output   : -
+============================================================================= */
+void Test_Probe(unsigned int address) __naked
+{
+address;	//HL
+__asm
+  ld   A,L
+  out  (TEST_PORT_PROBE),A
+  ld   A,H
+  out  (TEST_PORT_PROBE),A
+  ret
+__endasm;
+}
+
+
+
+/* =============================================================================
+ Test_Bench
+
+ Function : Send a command to the benchmark of the harness
+ Input    : [command] TEST_BENCH_CALL, TEST_BENCH_INT, TEST_BENCH_TOTAL,
+                      TEST_BENCH_DI or TEST_BENCH_ENTRY
+ Output   : -
+============================================================================= */
+void Test_Bench(char command) __naked
+{
+command;	//A
+__asm
+  out  (TEST_PORT_BENCH),A
+  ret
+__endasm;
+}
@@ -0,0 +1,415 @@
+/* =============================================================================
+Test interruptM1_Dispatch Library (harness)
+Version: 1.0 (17/10/2026)
+Architecture: MSX (msxemu test harness)
+Format: COM (MSX-DOS)
+Programming language: C and Assembler
+Compiler: SDCC 4.4 or newer
+
+Description:
+Checks the VBLANK dispatcher in the TIMI hook and as generated ISR:
+priorities, dividers, pause and resume, remove, table full, segments of the
+memory mapper and frame budget. Returns the number of failed tests.
+============================================================================= */
+
+#include "../include/test.h"
+
+#include "../../ISR/sources/include/interruptM1_ISR.h"
+#include "../../ISR/sources/include/interruptM1_Dispatch.h"
+#include "../../Hooks/sources/include/interruptM1_Hooks.h"
+
+
+
+// ----------------------------------------------------------------- definitions
+#define HINT		0x0038
+#define HTIMI		0xFD9F
+#define STATFL		0xF3E7
+
+
+
+// ---------------------------------------------------- Declaration of functions
+void Handler_A(void);
+void Handler_B(void);
+void Handler_Segment(void);
+void Handler_Program(void);
+void KEYI_Counter(void);
+
+char Get_Segment2(void);
+void Reset_Counters(void);
+
+void Test_Hook(void);
+void Test_Divider(void);
+void Test_Pause(void);
+void Test_Remove(void);
+void Test_Full(void);
+void Test_ISR(void);
+void Test_Segment(void);
+void Test_Budget(void);
+
+
+
+// ------------------------------------------------------------ global variables
+volatile unsigned int count_A;
+volatile unsigned int count_B;
+volatile unsigned int frame_B;	// DISPATCH_frames in the last call of Handler_B
+volatile unsigned int keyi_count;
+volatile unsigned int segment_ok;
+volatile unsigned int program_ok;
+char program_segment;			// segment of page 2 of the program
+volatile char first;			// 'A' or 'B': first handler called
+
+unsigned int bios_isr;			// vector of the ISR at start
+char dispatch_code[2 * DISPATCH_CODE_SIZE];	// generated code (the harness has RAM in all the pages)
+
+
+
+// ------------------------------------------------------------------- Functions
+
+
+//
+char main(void)
+{
+	Test_Print("interruptM1_Dispatch\n");
+
+	bios_isr = PEEKW(HINT+1);
+	Save_ISR();
+	Save_TIMI();
+	Save_KEYI();
+
+	Test_Hook();
+	Test_Divider();
+	Test_Pause();
+	Test_Remove();
+	Test_Full();
+	Test_ISR();
+	Test_Segment();
+	Test_Budget();
+
+	DisableI;
+	Restore_ISR();
+	Restore_TIMI();
+	Restore_KEYI();
+	EnableI;
+
+	return Test_End();
+}
+
+
+
+// ----------------------------------------------------------------- Handlers
+
+void Handler_A(void)
+{
+	if (!first) first = 'A';
+	count_A++;
+}
+
+
+
+void Handler_B(void)
+{
+	if (!first) first = 'B';
+	count_B++;
+	frame_B = DISPATCH_frames;
+}
+
+
+
+// Checks the segment selected in page 2
+void Handler_Segment(void)
+{
+	if (Get_Segment2() == 5) segment_ok++;
+}
+
+
+
+// Handler after the segmented one: page 2 of the program
+void Handler_Program(void)
+{
+	if (Get_Segment2() == program_segment) program_ok++;
+}
+
+
+
+void KEYI_Counter(void)
+{
+	keyi_count++;
+}
+
+
+
+char Get_Segment2(void) __naked
+{
+__asm
+  in   A,(0xFE)
+  and  #0x07
+  ret
+__endasm;
+}
+
+
+
+// Leaves the interrupts disabled: Test_Frames enables them just before HALT
+void Reset_Counters(void)
+{
+	DisableI;
+	count_A = 0;
+	count_B = 0;
+	keyi_count = 0;
+	segment_ok = 0;
+	program_ok = 0;
+	first = 0;
+	frame_B = 0;
+	DISPATCH_frames = 0;
+	DISPATCH_deferred = 0;
+}
+
+
+
+// -------------------------------------------------------------------- Tests
+
+void Test_Hook(void)
+{
+	Init_Dispatcher(dispatch_code);
+	Install_Dispatcher();
+	Reset_Counters();
+	Test_Frames(2);
+	Test_Check("Init_Dispatcher: frames counted without handlers", DISPATCH_frames == 2);
+	Test_Check("Init_Dispatcher: code in the buffer of the program",
+		PEEKW(HTIMI+1) >= (unsigned int)dispatch_code && PEEKW(HTIMI+1) < (unsigned int)dispatch_code + 2 * DISPATCH_CODE_SIZE);
+
+	Add_Handler(Handler_A, 1);
+	Add_Handler(Handler_B, 5);
+	Install_Dispatcher();
+	Test_Check("Install_Dispatcher sets the TIMI hook", PEEK(HTIMI) == 0xC3);
+
+	Reset_Counters();
+	Test_Frames(3);
+	Test_Check("handlers called in each frame", count_A == 3 && count_B == 3);
+	Test_Check("higher priority first", first == 'B');
+	Test_Check("DISPATCH_frames", DISPATCH_frames == 3);
+}
+
+
+
+void Test_Divider(void)
+{
+	Set_HandlerDivider(Handler_A, 2, 0);
+	Set_HandlerDivider(Handler_B, 3, 1);
+	Reset_Counters();
+	Test_Frames(12);
+	Test_Check("Set_HandlerDivider: one of each N frames", count_A == 6 && count_B == 4);
+
+	// frames 65535, 0 and 3 of 65535 to 3: the phase is kept when DISPATCH_frames wraps
+	Set_HandlerDivider(Handler_B, 1, 0);
+	Reset_Counters();
+	DISPATCH_frames = 65534;
+	Set_HandlerDivider(Handler_A, 3, 0);
+	Test_Frames(5);
+	Test_Check("Set_HandlerDivider: phase kept when the frames wrap", count_A == 3);
+	Set_HandlerDivider(Handler_A, 1, 0);
+	Set_HandlerDivider(Handler_B, 1, 0);
+}
+
+
+
+void Test_Pause(void)
+{
+	// Handler_A is the last one in the TIMI hook
+	Test_Check("Pause_Handler: found", Pause_Handler(Handler_A) && Pause_Handler(Handler_B));
+	Reset_Counters();
+	Test_Frames(3);
+	Test_Check("Pause_Handler: not called", count_A == 0 && count_B == 0 && DISPATCH_frames == 3);
+
+	Resume_Handler(Handler_A);
+	Resume_Handler(Handler_B);
+	Reset_Counters();
+	Test_Frames(3);
+	Test_Check("Resume_Handler: called", count_A == 3 && count_B == 3);
+
+	// the paused state is kept when the code is generated again
+	Pause_Handler(Handler_B);
+	Set_HandlerDivider(Handler_A, 1, 0);
+	Reset_Counters();
+	Test_Frames(3);
+	Test_Check("Pause_Handler: kept after a change", count_A == 3 && count_B == 0);
+	Resume_Handler(Handler_B);
+
+	// TIMI hook paused (RET): the code generated again is set in the hook
+	Pause_TIMI();
+	Remove_Handler(Handler_B);
+	Add_Handler(Handler_B, 5);
+	Remove_Handler(Handler_B);
+	Reset_Counters();
+	Test_Frames(3);
+	Test_Check("Pause_TIMI: dispatcher not called", count_A == 0 && DISPATCH_frames == 0);
+	Resume_TIMI();
+	Reset_Counters();
+	Test_Frames(3);
+	Test_Check("Pause_TIMI: the hook follows the new code", count_A == 3 && count_B == 0);
+	Add_Handler(Handler_B, 5);
+}
+
+
+
+void Test_Remove(void)
+{
+	Test_Check("Remove_Handler: found", Remove_Handler(Handler_B));
+	Test_Check("Remove_Handler: not found", !Remove_Handler(Handler_B));
+	Reset_Counters();
+	Test_Frames(3);
+	Test_Check("Remove_Handler: not called", count_A == 3 && count_B == 0);
+}
+
+
+
+void Test_Full(void)
+{
+	char i, added = 1;
+
+	Init_Dispatcher(dispatch_code);
+	Install_Dispatcher();
+	for (i = 0; i < DISPATCH_MAX; i++) added &= Add_Handler(Handler_A, i);
+	Test_Check("Add_Handler: DISPATCH_MAX handlers", added);
+	Test_Check("Add_Handler: table full", !Add_Handler(Handler_B, 0));
+
+	Reset_Counters();
+	Test_Frames(2);
+	Test_Check("Add_Handler: all the handlers called", count_A == 2 * DISPATCH_MAX);
+}
+
+
+
+void Test_ISR(void)
+{
+	char regs;
+
+	Disable_TIMI();
+	Init_Dispatcher(dispatch_code);
+	Add_Handler(Handler_A, 0);
+	Install_KEYI(KEYI_Counter);
+	Install_DispatcherISR(DISPATCH_ISR_KEYI | DISPATCH_ISR_ALTREGS | DISPATCH_ISR_INDEXREGS);
+	Test_Check("Install_DispatcherISR sets the vector", PEEK(HINT) == 0xC3 && PEEKW(HINT+1) != bios_isr);
+
+	Reset_Counters();
+	Test_Frames(3);
+	Test_Check("ISR: handlers and KEYI called", count_A == 3 && keyi_count == 3);
+	regs = Test_Registers();
+	Test_Check("ISR: all the registers kept", regs == TEST_ALLREGS);
+
+	// generated again: the vector follows the new code
+	Add_Handler(Handler_B, 1);
+	Reset_Counters();
+	Test_Frames(3);
+	Test_Check("ISR: new handler called", count_A == 3 && count_B == 3 && keyi_count == 3);
+
+	Install_DispatcherISR(0);
+	Reset_Counters();
+	Test_Frames(3);
+	Test_Check("ISR without options: KEYI not called", count_A == 3 && keyi_count == 0);
+	// IY is always saved and the C handlers keep IX
+	regs = Test_Registers();
+	Test_Check("ISR without options: main and index registers kept",
+		(regs & (TEST_MAINREGS | TEST_INDEXREGS)) == (TEST_MAINREGS | TEST_INDEXREGS));
+
+	Restore_ISR();
+}
+
+
+
+void Test_Segment(void)
+{
+	program_segment = Get_Segment2();
+
+	Init_Dispatcher(dispatch_code);
+	Add_Handler(Handler_Segment, 1);
+	Add_Handler(Handler_Program, 0);
+	Set_HandlerSegment(Handler_Segment, 5);
+	Install_Dispatcher();
+
+	// ISR of the BIOS: the dispatcher selects again the segment of the program
+	Reset_Counters();
+	Test_Frames(3);
+	Test_Check("Set_HandlerSegment: segment selected", segment_ok == 3);
+	Test_Check("Set_HandlerSegment: next handler with the segment of the program", program_ok == 3);
+	Test_Check("Set_HandlerSegment: segment restored", Get_Segment2() == program_segment);
+
+	// the segment is also restored after the last handler
+	Remove_Handler(Handler_Program);
+	Reset_Counters();
+	Test_Frames(3);
+	Test_Check("Set_HandlerSegment: last handler, segment restored",
+		segment_ok == 3 && Get_Segment2() == program_segment);
+
+	Install_ISR(ISR_DOS2);
+	Reset_Counters();
+	Test_Frames(3);
+	Test_Check("ISR_DOS2: segment restored", segment_ok == 3 && Get_Segment2() == program_segment);
+
+	Restore_ISR();
+}
+
+
+
+void Test_Budget(void)
+{
+	Init_Dispatcher(dispatch_code);
+	Add_Handler(Handler_A, 5);
+	Add_Handler(Handler_B, 1);
+	Install_Dispatcher();
+	Set_FrameBudget(1000);
+	Set_HandlerCost(Handler_A, 600);
+	Set_HandlerCost(Handler_B, 600);
+
+	// B does not fit: it is deferred and executed in the next frame
+	Reset_Counters();
+	Test_Frames(4);
+	Test_Check("Set_FrameBudget: deferred handler executed in the next frame",
+		count_A == 4 && count_B == 2);
+	Test_Check("DISPATCH_deferred", DISPATCH_deferred == 2);
+
+	// a paused handler does not use the budget
+	Pause_Handler(Handler_A);
+	Reset_Counters();
+	Test_Frames(4);
+	Test_Check("Set_FrameBudget: paused handler out of the budget",
+		count_A == 0 && count_B == 4 && DISPATCH_deferred == 0);
+	Resume_Handler(Handler_A);
+	Reset_Counters();
+	Test_Frames(4);
+	Test_Check("Set_FrameBudget: resumed handler", count_A == 4 && count_B == 2);
+
+	// with divider 2: deferred in frames 2, 4 and 6, executed in frames 3 and 5
+	Set_HandlerCost(Handler_B, 600);
+	Reset_Counters();
+	Set_HandlerDivider(Handler_B, 2, 0);
+	Test_Frames(6);
+	Test_Check("Set_FrameBudget: deferred handler with divider executed in the next frame",
+		count_A == 6 && count_B == 2 && DISPATCH_deferred == 3 && frame_B == 5);
+
+	// paused in frames 1 and 2: the counter keeps running, executed in frames 4 and 6
+	Pause_Handler(Handler_A);
+	Set_HandlerCost(Handler_B, 600);
+	Reset_Counters();
+	Set_HandlerDivider(Handler_B, 2, 0);
+	Pause_Handler(Handler_B);
+	Test_Frames(2);
+	Resume_Handler(Handler_B);
+	Test_Frames(4);
+	Test_Check("Set_FrameBudget: paused handler with divider keeps its phase",
+		count_B == 2 && frame_B == 6);
+	Resume_Handler(Handler_A);
+	Set_HandlerDivider(Handler_B, 1, 0);
+
+	// the BIOS saves A in STATFL after the TIMI hook
+	*(char*)STATFL = 0;
+	Reset_Counters();
+	Test_Frames(2);
+	Test_Check("TIMI hook: A kept (STATFL)", PEEK(STATFL) & 0x80);
+
+	Set_FrameBudget(0);
+	Reset_Counters();
+	Test_Frames(4);
+	Test_Check("Set_FrameBudget(0): all executed", count_A == 4 && count_B == 4);
+	Test_Check("Set_HandlerCost: not found", !Set_HandlerCost(Handler_Segment, 10));
+}
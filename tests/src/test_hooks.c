@@ -0,0 +1,363 @@
+/* =============================================================================
+Test interruptM1_Hooks Library (harness)
+Version: 1.0 (17/10/2026)
+Architecture: MSX (msxemu test harness)
+Format: COM (MSX-DOS)
+Programming language: C and Assembler
+Compiler: SDCC 4.4 or newer
+
+Description:
+Checks the hook functions with the ISR of the BIOS: save, install, restore,
+disable, pause and resume of TIMI, KEYI and generic hooks, chained hooks,
+the registry of saved hooks and the TIMI subscribers.
+Returns the number of failed tests.
+============================================================================= */
+
+#include "../include/test.h"
+
+#include "../../Hooks/sources/include/interruptM1_Hooks.h"
+#include "../../Hooks/sources/include/interruptM1_Subscribers.h"
+
+
+
+// ----------------------------------------------------------------- definitions
+#define RET_CODE	0xC9
+#define JP_CODE		0xC3
+
+
+
+// ---------------------------------------------------- Declaration of functions
+void Counter_A(void);
+void Counter_B(void);
+void Counter_C(void);
+void KEYI_Counter(void);
+
+char Hook_Is(unsigned int hook, char opcode, void (*func)(void));
+void Reset_Counters(void);
+
+void Test_TIMI(void);
+void Test_KEYI(void);
+void Test_Chained(void);
+void Test_Generic(void);
+void Test_PauseResume(void);
+void Test_Registry(void);
+void Test_Subscribers(void);
+
+
+
+// ------------------------------------------------------------ global variables
+volatile unsigned int count_A;
+volatile unsigned int count_B;
+volatile unsigned int count_C;
+volatile unsigned int keyi_count;
+volatile char first;			// 'A' or 'B': first function called
+
+char slot1[HOOK_SIZE];
+char slot2[HOOK_SIZE];
+char slots[HOOKS_MAX + 1][HOOK_SIZE];
+char chain[HOOK_CHAIN_SIZE];		// trampoline (the harness has RAM in all the pages)
+char chain2[HOOK_CHAIN_SIZE];		// trampoline of the second chained function
+char subs[TIMI_SUBS_SIZE];			// list of subscribers
+
+TIMI_SUBSCRIBER node1;
+TIMI_SUBSCRIBER node2;
+
+
+
+// ------------------------------------------------------------------- Functions
+
+
+//
+char main(void)
+{
+	Test_Print("interruptM1_Hooks\n");
+
+	Test_TIMI();
+	Test_KEYI();
+	Test_Chained();
+	Test_Generic();
+	Test_PauseResume();
+	Test_Registry();
+	Test_Subscribers();
+
+	return Test_End();
+}
+
+
+
+// ----------------------------------------------------------------- Handlers
+
+void Counter_A(void)
+{
+	if (!first) first = 'A';
+	count_A++;
+}
+
+
+
+void Counter_B(void)
+{
+	if (!first) first = 'B';
+	count_B++;
+}
+
+
+
+void Counter_C(void)
+{
+	count_C++;
+}
+
+
+
+void KEYI_Counter(void)
+{
+	keyi_count++;
+}
+
+
+
+// Checks the opcode and the address of a hook
+char Hook_Is(unsigned int hook, char opcode, void (*func)(void))
+{
+	return PEEK(hook) == opcode && PEEKW(hook + 1) == (unsigned int)func;
+}
+
+
+
+// Leaves the interrupts disabled: Test_Frames enables them just before HALT
+void Reset_Counters(void)
+{
+	DisableI;
+	count_A = 0;
+	count_B = 0;
+	count_C = 0;
+	keyi_count = 0;
+}
+
+
+
+// -------------------------------------------------------------------- Tests
+
+void Test_TIMI(void)
+{
+	char old = PEEK(HOOK_TIMI);
+
+	Save_TIMI();
+	Install_TIMI(Counter_A);
+	Test_Check("Install_TIMI sets JP func", Hook_Is(HOOK_TIMI, JP_CODE, Counter_A));
+	Reset_Counters();
+	Test_Frames(3);
+	Test_Check("TIMI: function called in each VBLANK", count_A == 3);
+
+	Pause_TIMI();
+	Test_Check("Pause_TIMI sets RET and keeps the address", Hook_Is(HOOK_TIMI, RET_CODE, Counter_A));
+	Reset_Counters();
+	Test_Frames(3);
+	Test_Check("Pause_TIMI: function not called", count_A == 0);
+
+	Resume_TIMI();
+	Test_Check("Resume_TIMI sets JP func", Hook_Is(HOOK_TIMI, JP_CODE, Counter_A));
+	Reset_Counters();
+	Test_Frames(3);
+	Test_Check("Resume_TIMI: function called", count_A == 3);
+
+	Disable_TIMI();
+	Test_Check("Disable_TIMI sets RET", PEEK(HOOK_TIMI) == RET_CODE);
+	Resume_TIMI();
+	Test_Check("Resume_TIMI does not enable a disabled hook", PEEK(HOOK_TIMI) == RET_CODE);
+
+	DisableI;
+	Install_TIMI(Counter_A);
+	Test_Check("Install_TIMI keeps the interrupts disabled", !Test_IFF());
+	EnableI;
+	Restore_TIMI();
+	Test_Check("Restore_TIMI keeps the interrupts enabled", Test_IFF());
+	Test_Check("Restore_TIMI sets the saved hook", PEEK(HOOK_TIMI) == old);
+}
+
+
+
+void Test_KEYI(void)
+{
+	char old = PEEK(HOOK_KEYI);
+
+	Save_KEYI();
+	Install_KEYI(KEYI_Counter);
+	Test_Check("Install_KEYI sets JP func", Hook_Is(HOOK_KEYI, JP_CODE, KEYI_Counter));
+	Reset_Counters();
+	Test_Frames(3);
+	Test_Check("KEYI: function called in each interrupt", keyi_count == 3);
+
+	Pause_KEYI();
+	Reset_Counters();
+	Test_Frames(3);
+	Test_Check("Pause_KEYI: function not called", keyi_count == 0);
+	Resume_KEYI();
+	Reset_Counters();
+	Test_Frames(3);
+	Test_Check("Resume_KEYI: function called", keyi_count == 3);
+
+	Disable_KEYI();
+	Test_Check("Disable_KEYI sets RET", PEEK(HOOK_KEYI) == RET_CODE);
+	Restore_KEYI();
+	Test_Check("Restore_KEYI sets the saved hook", PEEK(HOOK_KEYI) == old);
+}
+
+
+
+void Test_Chained(void)
+{
+	Save_TIMI();
+	Install_TIMI(Counter_B);
+	Save_TIMI();
+	Install_TIMI_Chained(Counter_A, chain);
+	Test_Check("Install_TIMI_Chained: the hook jumps to the buffer",
+		PEEK(HOOK_TIMI) == JP_CODE && PEEKW(HOOK_TIMI+1) == (unsigned int)chain);
+	Reset_Counters();
+	first = 0;
+	Test_Frames(3);
+	Test_Check("Install_TIMI_Chained: new and old functions called", count_A == 3 && count_B == 3);
+	Test_Check("Install_TIMI_Chained: new function first", first == 'A');
+
+	Install_TIMI_Chained(Counter_C, chain2);
+	Reset_Counters();
+	Test_Frames(3);
+	Test_Check("Install_TIMI_Chained twice: the first chain is kept",
+		count_C == 3 && count_A == 3 && count_B == 3);
+
+	Restore_TIMI();
+	Test_Check("Restore_TIMI after chained", Hook_Is(HOOK_TIMI, JP_CODE, Counter_B));
+	Reset_Counters();
+	Test_Frames(3);
+	Test_Check("Restore_TIMI: only the old function called", count_A == 0 && count_B == 3);
+	Disable_TIMI();
+}
+
+
+
+void Test_Generic(void)
+{
+	char i, same = 1;
+	char old[HOOK_SIZE];
+
+	for (i = 0; i < HOOK_SIZE; i++) old[i] = PEEK(HOOK_CHPU + i);
+
+	Save_Hook(HOOK_CHPU, slot1);
+	for (i = 0; i < HOOK_SIZE; i++) same &= slot1[i] == old[i];
+	Test_Check("Save_Hook copies 5 bytes", same);
+
+	Install_Hook(HOOK_CHPU, Counter_A);
+	Test_Check("Install_Hook sets JP func", Hook_Is(HOOK_CHPU, JP_CODE, Counter_A));
+
+	Pause_Hook(HOOK_CHPU);
+	Test_Check("Pause_Hook sets RET", Hook_Is(HOOK_CHPU, RET_CODE, Counter_A));
+	Resume_Hook(HOOK_CHPU);
+	Test_Check("Resume_Hook sets JP", Hook_Is(HOOK_CHPU, JP_CODE, Counter_A));
+
+	Disable_Hook(HOOK_CHPU);
+	Test_Check("Disable_Hook sets RET", PEEK(HOOK_CHPU) == RET_CODE);
+	Test_Check("Disable_Hook writes C9 C9 C9",
+		PEEK(HOOK_CHPU+1) == RET_CODE && PEEK(HOOK_CHPU+2) == RET_CODE);
+
+	Restore_Hook(HOOK_CHPU, slot1);
+	same = 1;
+	for (i = 0; i < HOOK_SIZE; i++) same &= PEEK(HOOK_CHPU + i) == old[i];
+	Test_Check("Restore_Hook restores 5 bytes", same);
+}
+
+
+
+void Test_PauseResume(void)
+{
+	char i;
+
+	Save_Hook(HOOK_CHPU, slot1);
+
+	// hook not installed: RET, 0xC9C9
+	for (i = 0; i < HOOK_SIZE; i++) PEEK(HOOK_CHPU + i) = RET_CODE;
+	Resume_Hook(HOOK_CHPU);
+	Test_Check("Resume_Hook: hook not installed kept", PEEK(HOOK_CHPU) == RET_CODE);
+
+	// inter-slot call to other ROM (RST 30h)
+	PEEK(HOOK_CHPU) = 0xF7;
+	PEEK(HOOK_CHPU + 1) = 0x8F;
+	PEEKW(HOOK_CHPU + 2) = 0x4100;
+	Pause_Hook(HOOK_CHPU);
+	Test_Check("Pause_Hook: RST 30h kept", PEEK(HOOK_CHPU) == 0xF7);
+	Resume_Hook(HOOK_CHPU);
+	Test_Check("Resume_Hook: RST 30h kept", PEEK(HOOK_CHPU) == 0xF7);
+
+	Install_Hook(HOOK_CHPU, Counter_A);
+	Disable_Hook(HOOK_CHPU);
+	Resume_Hook(HOOK_CHPU);
+	Test_Check("Resume_Hook: disabled hook not enabled", PEEK(HOOK_CHPU) == RET_CODE);
+
+	Restore_Hook(HOOK_CHPU, slot1);
+}
+
+
+
+void Test_Registry(void)
+{
+	char i, added = 1;
+	char old = PEEK(HOOK_TIMI);
+
+	Init_HookRegistry();
+	Register_Hook(HOOK_TIMI, slot1);
+	Install_TIMI(Counter_A);
+	Register_Hook(HOOK_TIMI, slot2);
+	Install_TIMI(Counter_B);
+	Register_Hook(HOOK_KEYI, slots[0]);
+	Install_KEYI(KEYI_Counter);
+
+	Restore_AllHooks();
+	Test_Check("Restore_AllHooks restores in reverse order",
+		PEEK(HOOK_TIMI) == old && PEEK(HOOK_KEYI) == RET_CODE);
+
+	Init_HookRegistry();
+	for (i = 0; i < HOOKS_MAX; i++) added &= Register_Hook(HOOK_CHPU, slots[i]);
+	Test_Check("Register_Hook: HOOKS_MAX hooks", added);
+	Test_Check("Register_Hook: registry full", !Register_Hook(HOOK_CHPU, slots[HOOKS_MAX]));
+	Init_HookRegistry();
+}
+
+
+
+void Test_Subscribers(void)
+{
+	char old = PEEK(HOOK_TIMI);
+
+	Init_Subscribers(subs);
+	Install_Subscribers();
+	Test_Check("Install_Subscribers: hook jumps to the list", PEEKW(HOOK_TIMI + 1) == (unsigned int)subs);
+	Subscribe_TIMI(&node1, Counter_A);
+	Subscribe_TIMI(&node2, Counter_B);
+	Reset_Counters();
+	first = 0;
+	Test_Frames(3);
+	Test_Check("Subscribe_TIMI: all the subscribers called", count_A == 3 && count_B == 3);
+	Test_Check("Subscribe_TIMI: last subscriber first", first == 'B');
+
+	Pause_Subscriber(&node1);
+	Reset_Counters();
+	Test_Frames(3);
+	Test_Check("Pause_Subscriber", count_A == 0 && count_B == 3);
+	Resume_Subscriber(&node1);
+	Reset_Counters();
+	Test_Frames(3);
+	Test_Check("Resume_Subscriber", count_A == 3 && count_B == 3);
+
+	Unsubscribe_TIMI(&node2);
+	Reset_Counters();
+	Test_Frames(3);
+	Test_Check("Unsubscribe_TIMI", count_A == 3 && count_B == 0);
+
+	Unsubscribe_TIMI(&node1);
+	Reset_Counters();
+	Test_Frames(3);
+	Test_Check("Unsubscribe_TIMI: empty list", count_A == 0 && count_B == 0);
+
+	Restore_Subscribers();
+	Test_Check("Restore_Subscribers", PEEK(HOOK_TIMI) == old);
+}
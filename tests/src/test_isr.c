@@ -0,0 +1,555 @@
+/* =============================================================================
+Test interruptM1_ISR Library (harness)
+Version: 1.0 (17/10/2026)
+Architecture: MSX (msxemu test harness)
+Format: COM (MSX-DOS)
+Programming language: C and Assembler
+Compiler: SDCC 4.4 or newer
+
+Description:
+Checks the ISR functions and variants: vector, state of the interrupts,
+hooks called in each interrupt, registers kept, STATFL, nested ISR, own
+stack, mapper segments, relocated ISR, line interrupt, deferred work queue
+and C handlers. Returns the number of failed tests.
+============================================================================= */
+
+#include "../include/test.h"
+
+#include "../../ISR/sources/include/interruptM1_ISR.h"
+#include "../../ISR/sources/include/interruptM1_Stack.h"
+#include "../../ISR/sources/include/interruptM1_LineInt.h"
+#include "../../ISR/sources/include/interruptM1_Deferred.h"
+#include "../../ISR/sources/include/interruptM1_Wrapper.h"
+#include "../../Hooks/sources/include/interruptM1_Hooks.h"
+
+
+
+// ----------------------------------------------------------------- definitions
+#define HINT		0x0038
+#define HKEYI		0xFD9A
+#define HTIMI		0xFD9F
+#define STATFL		0xF3E7
+
+#define RELOC_ADDRESS	0xD000	// page 3, under the stack of MSX-DOS
+
+#define V_TIMI		0x01	// calls the TIMI hook
+#define V_KEYI		0x02	// calls the KEYI hook
+
+typedef struct {
+	ISR_FUNC isr;
+	char* name;
+	char hooks;		// V_TIMI | V_KEYI
+	char regs;		// registers kept (Test_Registers)
+} ISR_VARIANT;
+
+
+
+// ---------------------------------------------------- Declaration of functions
+void TIMI_Counter(void);
+void KEYI_Counter(void);
+void TIMI_Segment(void);
+void TIMI_RaiseDevice(void);
+void TIMI_Status(void);
+void TIMI_Post(void);
+void Line_Counter(void);
+void Deferred_Work(unsigned int arg);
+void Wrapped_Handler(char status);
+void Wrapped_Hook(void);
+
+char Get_Segment2(void);
+
+void Test_Vector(void);
+void Test_Critical(void);
+void Test_Variant(ISR_VARIANT* variant);
+void Test_Disable(void);
+void Test_Auto(void);
+void Test_Nested(void);
+void Test_Stack(void);
+void Test_DOS2(void);
+void Test_Reloc(void);
+void Test_LineInt(void);
+void Test_Deferred(void);
+void Test_Wrapper(void);
+
+void Reset_Counters(void);
+
+
+
+// ------------------------------------------------------------------- constants
+ISR_VARIANT variants[] = {
+	{ISR_Basic,       "ISR_Basic",       V_TIMI | V_KEYI, TEST_ALLREGS},
+	{ISR_Basic_NoAlt, "ISR_Basic_NoAlt", V_TIMI | V_KEYI, TEST_ALLREGS},
+	{ISR_TIMI,        "ISR_TIMI",        V_TIMI,          TEST_ALLREGS},
+	{ISR_TIMI_NoAlt,  "ISR_TIMI_NoAlt",  V_TIMI,          TEST_ALLREGS},
+	{ISR_KEYI,        "ISR_KEYI",        V_KEYI,          TEST_ALLREGS},
+	{ISR_NoHooks,     "ISR_NoHooks",     0,               TEST_ALLREGS},
+	{ISR_Line,        "ISR_Line",        V_TIMI | V_KEYI, TEST_ALLREGS},
+	{ISR_DOS2,        "ISR_DOS2",        V_TIMI | V_KEYI, TEST_ALLREGS},
+	{ISR_Stack,       "ISR_Stack",       V_TIMI | V_KEYI, TEST_ALLREGS},
+	// works on the alternate registers of the program
+	{ISR_Shadow,      "ISR_Shadow",      V_TIMI | V_KEYI, TEST_MAINREGS | TEST_INDEXREGS},
+	{ISR_Nested,      "ISR_Nested",      V_TIMI | V_KEYI, TEST_ALLREGS}
+};
+
+#define VARIANTS	(sizeof(variants) / sizeof(ISR_VARIANT))
+
+
+
+// ------------------------------------------------------------ global variables
+volatile unsigned int timi_count;
+volatile unsigned int keyi_count;
+volatile unsigned int device_count;
+volatile unsigned int line_count;
+volatile unsigned int nested_count;
+volatile unsigned int deferred_count;
+volatile unsigned int wrapped_count;
+volatile char in_timi;
+
+
+
+// ------------------------------------------------------------------- Functions
+
+
+//
+char main(void)
+{
+	char i;
+
+	Test_Print("interruptM1_ISR\n");
+
+	Save_ISR();
+	Save_TIMI();
+	Save_KEYI();
+
+	Init_LineInt();
+	Init_ISR_Nested();
+
+	Test_Vector();
+	Test_Critical();
+	for (i = 0; i < VARIANTS; i++) Test_Variant(&variants[i]);
+	Test_Disable();
+	Test_Auto();
+	Test_Nested();
+	Test_Stack();
+	Test_DOS2();
+	Test_Reloc();
+	Test_LineInt();
+	Test_Deferred();
+	Test_Wrapper();
+
+	DisableI;
+	Restore_ISR();
+	Restore_TIMI();
+	Restore_KEYI();
+	EnableI;
+
+	return Test_End();
+}
+
+
+
+// ----------------------------------------------------------------- Handlers
+
+void TIMI_Counter(void)
+{
+	timi_count++;
+}
+
+
+
+void KEYI_Counter(void)
+{
+	keyi_count++;
+	if (Test_DeviceAck())
+	{
+		device_count++;
+		if (in_timi) nested_count++;
+	}
+}
+
+
+
+// Changes the segment of page 2 (the ISR must restore it)
+void TIMI_Segment(void) __naked
+{
+__asm
+  ld   A,#7
+  out  (0xFE),A
+  jp   _TIMI_Counter
+__endasm;
+}
+
+
+
+// Raises the device interrupt twice while the VBLANK work is running
+void TIMI_RaiseDevice(void)
+{
+	in_timi = 1;
+	Test_Device(1);
+	Test_Device(1);
+	timi_count++;
+	in_timi = 0;
+}
+
+
+
+// Counts only if it receives the VDP status (VBLANK) in A
+void TIMI_Status(void) __naked
+{
+__asm
+  and  #0x80
+  ret  Z
+  jp   _TIMI_Counter
+__endasm;
+}
+
+
+
+void TIMI_Post(void)
+{
+	timi_count++;
+	Post_Deferred(Deferred_Work, timi_count);
+}
+
+
+
+void Line_Counter(void)
+{
+	line_count++;
+}
+
+
+
+void Deferred_Work(unsigned int arg)
+{
+	if (arg) deferred_count++;
+}
+
+
+
+void Wrapped_Handler(char status)
+{
+	if (status & 0x80) wrapped_count++;
+}
+
+ISR_C_HANDLER(ISR_Wrapped, Wrapped_Handler)
+
+HOOK_C_HANDLER(Wrapped_Hook, TIMI_Counter)
+
+
+
+char Get_Segment2(void) __naked
+{
+__asm
+  in   A,(0xFE)
+  and  #0x07
+  ret
+__endasm;
+}
+
+
+
+// Leaves the interrupts disabled: Test_Frames enables them just before HALT,
+// so no interrupt is lost or counted twice
+void Reset_Counters(void)
+{
+	DisableI;
+	timi_count = 0;
+	keyi_count = 0;
+	device_count = 0;
+	line_count = 0;
+	nested_count = 0;
+	deferred_count = 0;
+	wrapped_count = 0;
+	in_timi = 0;
+}
+
+
+
+// -------------------------------------------------------------------- Tests
+
+void Test_Vector(void)
+{
+	unsigned int old = PEEKW(HINT+1);
+
+	Install_ISR(ISR_Basic);
+	Test_Check("Install_ISR sets JP isr in 0x0038",
+		PEEK(HINT) == 0xC3 && PEEKW(HINT+1) == (unsigned int)ISR_Basic);
+
+	Restore_ISR();
+	Test_Check("Restore_ISR sets the saved vector", PEEKW(HINT+1) == old);
+
+	DisableI;
+	Install_ISR(ISR_Basic);
+	Test_Check("Install_ISR keeps the interrupts disabled", !Test_IFF());
+	Restore_ISR();
+	Test_Check("Restore_ISR keeps the interrupts disabled", !Test_IFF());
+	EnableI;
+	Install_ISR(ISR_Basic);
+	Test_Check("Install_ISR keeps the interrupts enabled", Test_IFF());
+	Restore_ISR();
+}
+
+
+
+void Test_Critical(void)
+{
+	char disabled, inner, outer, extra;
+
+	EnableI;
+	EnterCritical();
+	EnterCritical();
+	disabled = !Test_IFF() && ISR_critical == 2;
+	inner = ExitCritical();
+	disabled &= !Test_IFF();
+	outer = ExitCritical();
+
+	Test_Check("nested ExitCritical keeps the interrupts disabled", disabled && inner);
+	Test_Check("outer ExitCritical enables the interrupts", outer && Test_IFF());
+	extra = ExitCritical();
+	Test_Check("ExitCritical without EnterCritical", !extra && Test_IFF() && ISR_critical == 0);
+
+	DisableI;
+	EnterCritical();
+	ExitCritical();
+	Test_Check("ExitCritical keeps the interrupts disabled", !Test_IFF());
+	EnableI;
+}
+
+
+
+void Test_Variant(ISR_VARIANT* variant)
+{
+	char regs;
+
+	Test_Print(variant->name);
+	Test_Print(":\n");
+
+	Install_TIMI(TIMI_Counter);
+	Install_KEYI(KEYI_Counter);
+	*(char*)STATFL = 0;
+	Install_ISR(variant->isr);
+
+	Reset_Counters();
+	Test_Frames(4);
+	DisableI;
+	Test_Check("  TIMI hook", timi_count == ((variant->hooks & V_TIMI) ? 4 : 0));
+	Test_Check("  KEYI hook", keyi_count == ((variant->hooks & V_KEYI) ? 4 : 0));
+	Test_Check("  STATFL", PEEK(STATFL) & 0x80);
+
+	regs = Test_Registers();
+	Test_Check("  registers kept", (regs & variant->regs) == variant->regs);
+
+	if (variant->hooks & V_KEYI)
+	{
+		Reset_Counters();
+		Test_Device(1);
+		Test_Frames(1);
+		DisableI;
+		Test_Check("  device interrupt", device_count == 1);
+	}
+
+	Restore_ISR();
+	EnableI;
+}
+
+
+
+void Test_Disable(void)
+{
+	Install_TIMI(TIMI_Counter);
+	Disable_ISR();
+	Reset_Counters();
+	Test_Frames(3);
+	Test_Check("Disable_ISR: hooks not called", timi_count == 0);
+	Restore_ISR();
+}
+
+
+
+void Test_Auto(void)
+{
+	Disable_TIMI();
+	Disable_KEYI();
+	Test_Check("Select_ISR_Auto: no hooks", Select_ISR_Auto() == ISR_NoHooks);
+	Install_TIMI(TIMI_Counter);
+	Test_Check("Select_ISR_Auto: TIMI", Select_ISR_Auto() == ISR_TIMI);
+	Install_KEYI(KEYI_Counter);
+	Test_Check("Select_ISR_Auto: TIMI and KEYI", Select_ISR_Auto() == ISR_Basic);
+	Disable_TIMI();
+	Test_Check("Select_ISR_Auto: KEYI", Select_ISR_Auto() == ISR_KEYI);
+
+	Install_ISR_Auto();
+	Test_Check("Install_ISR_Auto", PEEKW(HINT+1) == (unsigned int)ISR_KEYI);
+	Install_TIMI(TIMI_Counter);
+	Update_ISR_Auto();
+	Test_Check("Update_ISR_Auto", PEEKW(HINT+1) == (unsigned int)ISR_Basic);
+	Restore_ISR();
+}
+
+
+
+void Test_Nested(void)
+{
+	Install_TIMI(TIMI_RaiseDevice);
+	Install_KEYI(KEYI_Counter);
+
+	Install_ISR(ISR_Nested);
+	Reset_Counters();
+	Test_Frames(4);
+	DisableI;
+	Test_Check("ISR_Nested: KEYI attended inside TIMI", nested_count == 8 && device_count == 8);
+	Test_Check("ISR_Nested: TIMI not entered again", timi_count == 4);
+	Test_Check("ISR_Nested: ISR_busy released", ISR_busy == 0);
+
+	Install_TIMI(TIMI_Status);
+	Reset_Counters();
+	Test_Frames(4);
+	DisableI;
+	Test_Check("ISR_Nested: TIMI hook receives the VDP status", timi_count == 4);
+	Install_TIMI(TIMI_RaiseDevice);
+
+	Install_ISR(ISR_Basic);
+	Reset_Counters();
+	Test_Frames(4);
+	DisableI;
+	Test_Check("ISR_Basic: KEYI attended after TIMI", nested_count == 0 && device_count == 4);
+
+	Restore_ISR();
+	EnableI;
+}
+
+
+
+void Test_Stack(void)
+{
+	unsigned int peak;
+
+	Install_TIMI(TIMI_Counter);
+	Install_KEYI(KEYI_Counter);
+	Init_ISRStack();
+	Install_ISR(ISR_Stack);
+	Reset_Counters();
+	Test_Frames(2);
+	Restore_ISR();
+
+	peak = Get_ISRStackPeak();
+	Test_Check("ISR_Stack: own stack used", peak > 0 && peak < ISR_STACK_SIZE);
+}
+
+
+
+void Test_DOS2(void)
+{
+	char segment = Get_Segment2();
+
+	Install_TIMI(TIMI_Segment);
+	Install_ISR(ISR_DOS2);
+	Reset_Counters();
+	Test_Frames(2);
+	Restore_ISR();
+	Test_Check("ISR_DOS2: segment of page 2 restored",
+		timi_count == 2 && Get_Segment2() == segment);
+}
+
+
+
+void Test_Reloc(void)
+{
+	char regs;
+
+	Install_TIMI(TIMI_Counter);
+	Install_KEYI(KEYI_Counter);
+	Install_ISR_Reloc((char*)RELOC_ADDRESS);
+	Test_Check("Install_ISR_Reloc sets the vector", PEEKW(HINT+1) == RELOC_ADDRESS);
+
+	Reset_Counters();
+	Test_Frames(4);
+	Test_Check("ISR_Reloc: TIMI and KEYI hooks", timi_count == 4 && keyi_count == 4);
+	regs = Test_Registers();
+	Test_Check("ISR_Reloc: registers kept", regs == TEST_ALLREGS);
+
+	// the copy calls the function, not the hook
+	Test_Check("Install_TIMI_Direct returns 1", Install_TIMI_Direct(TIMI_Counter));
+	Test_Check("Install_TIMI_Direct sets the hook",
+		PEEK(HTIMI) == 0xC3 && PEEKW(HTIMI+1) == (unsigned int)TIMI_Counter);
+	Disable_TIMI();
+	Reset_Counters();
+	Test_Frames(4);
+	Test_Check("Install_TIMI_Direct: function called", timi_count == 4);
+
+	Reset_ISR_Direct();
+	Reset_Counters();
+	Test_Frames(4);
+	Test_Check("Reset_ISR_Direct: hook called", timi_count == 0);
+
+	Restore_ISR();
+	Test_Check("Install_TIMI_Direct: nothing after Restore_ISR",
+		!Install_TIMI_Direct(TIMI_Status) && PEEKW(HTIMI+1) == (unsigned int)TIMI_Counter);
+}
+
+
+
+void Test_LineInt(void)
+{
+	Install_TIMI(TIMI_Counter);
+	Install_ISR(ISR_Line);
+	Install_LineInt(Line_Counter, 100);
+	Reset_Counters();
+	while (timi_count < 4) Test_Frames(1);
+	DisableI;
+	Test_Check("ISR_Line: one line interrupt in each frame", line_count >= 3 && line_count <= 5);
+
+	Disable_LineInt();
+	Reset_Counters();
+	Test_Frames(4);
+	Test_Check("Disable_LineInt", line_count == 0 && timi_count == 4);
+
+	Restore_ISR();
+}
+
+
+
+void Test_Deferred(void)
+{
+	Init_Deferred();
+	Install_TIMI(TIMI_Post);
+	Install_ISR(ISR_Basic);
+	Reset_Counters();
+	Test_Frames(3);
+	RunDeferred();
+	Test_Check("Deferred: items executed", deferred_count == 3);
+
+	// the queue holds DEFER_SIZE-1 items
+	Reset_Counters();
+	Test_Frames(DEFER_SIZE + 4);
+	DisableI;
+	RunDeferred();
+	Test_Check("Deferred: full queue",
+		deferred_count == DEFER_SIZE - 1 && DEFER_overflow == 5);
+	EnableI;
+
+	Restore_ISR();
+}
+
+
+
+void Test_Wrapper(void)
+{
+	char regs;
+
+	Install_ISR(ISR_Wrapped);
+	Reset_Counters();
+	Test_Frames(4);
+	Test_Check("ISR_C_HANDLER: function called with the status", wrapped_count == 4);
+	regs = Test_Registers();
+	Test_Check("ISR_C_HANDLER: registers kept", regs == TEST_ALLREGS);
+
+	Install_TIMI(Wrapped_Hook);
+	Install_ISR(ISR_Basic);
+	Reset_Counters();
+	Test_Frames(4);
+	Test_Check("HOOK_C_HANDLER: function called", timi_count == 4);
+
+	Restore_ISR();
+}